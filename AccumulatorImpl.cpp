@@ -0,0 +1,213 @@
+#include "AccumulatorImpl.h"
+#include "VectorImpl.h"
+#include <algorithm>
+#include <memory.h>
+#include <new>
+
+namespace {
+    std::atomic<size_t> threadCount(0);
+
+    // Threads are spread over shards in order of their first addition
+    thread_local size_t threadOrdinal = threadCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+AccumulatorImpl::AccumulatorImpl(size_t dim) : dim(dim), memory(nullptr), sparse(nullptr) {}
+
+AccumulatorImpl::~AccumulatorImpl() {
+    for (size_t i = 0; i < shards.size(); i++)
+        shards[i]->~Shard();
+    delete[] memory;
+    delete[] sparse;
+}
+
+RC AccumulatorImpl::init(size_t shards) {
+    IContext const *const CONTEXT = IContext::current();
+    size_t header = (sizeof(Shard) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    size_t lines = dim / (CACHE_LINE / sizeof(double)) + (dim % (CACHE_LINE / sizeof(double)) != 0);
+    // Lines of one shard that keep size of the block representable
+    size_t limit = (SIZE_MAX - CACHE_LINE) / shards / CACHE_LINE;
+    if (limit <= header / CACHE_LINE || lines > limit - header / CACHE_LINE) {
+        CONTEXT->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    size_t stride = header + lines * CACHE_LINE;
+    memory = new(std::nothrow) uint8_t[shards * stride + CACHE_LINE - 1];
+    if (memory == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    uint8_t *base = memory + (CACHE_LINE - (uintptr_t) memory % CACHE_LINE) % CACHE_LINE;
+    try {
+        this->shards.reserve(shards);
+    } catch (std::bad_alloc &) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    for (size_t i = 0; i < shards; i++) {
+        Shard *shard = new(base + i * stride) Shard;
+        shard->data = (double *) (base + i * stride + header);
+        std::fill(shard->data, shard->data + dim, 0.0);
+        this->shards.push_back(shard);
+    }
+    sparse = new(std::nothrow) std::atomic<double>[dim];
+    if (sparse == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    for (size_t i = 0; i < dim; i++)
+        sparse[i].store(0, std::memory_order_relaxed);
+    return RC::SUCCESS;
+}
+
+AccumulatorImpl::Shard &AccumulatorImpl::ownShard() const {
+    return *shards[threadOrdinal % shards.size()];
+}
+
+RC AccumulatorImpl::addCord(IContext const *const &context, std::atomic<double> &cord, double val) {
+    double old = cord.load(std::memory_order_relaxed), sum;
+    do {
+        sum = old + val;
+        RC code = VectorImpl::elemCheck(context, sum);
+        if (code != RC::SUCCESS)
+            return code;
+    } while (!cord.compare_exchange_weak(old, sum, std::memory_order_relaxed));
+    return RC::SUCCESS;
+}
+
+size_t AccumulatorImpl::getDim() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return dim;
+}
+
+size_t AccumulatorImpl::getShards() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return shards.size();
+}
+
+RC AccumulatorImpl::inc(IVector const *const &op) {
+    IContext const *const CONTEXT = IContext::current();
+    if (op == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (op->getDim() != dim) {
+        CONTEXT->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    double const *src = op->getData();
+    Shard &shard = ownShard();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    double *dest = shard.data;
+    // Sums are checked before anything is written, as in VectorImpl::inc
+    if (CONTEXT->getValidation() == IContext::VALIDATION::FULL) {
+        const size_t block = 256;
+        double sum[block];
+        for (size_t begin = 0; begin < dim; begin += block) {
+            size_t count = dim - begin < block ? dim - begin : block;
+            for (size_t i = 0; i < count; i++)
+                sum[i] = dest[begin + i] + src[begin + i];
+            RC code = VectorImpl::arrayCheck(CONTEXT, sum, count);
+            if (code != RC::SUCCESS) {
+                CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+                return code;
+            }
+        }
+    }
+    for (size_t i = 0; i < dim; i++)
+        dest[i] += src[i];
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC AccumulatorImpl::inc(size_t index, double val) {
+    return inc(&index, 1, &val);
+}
+
+RC AccumulatorImpl::inc(size_t const *const &indices, size_t count, double const *const &values) {
+    IContext const *const CONTEXT = IContext::current();
+    if (indices == nullptr || values == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    for (size_t i = 0; i < count; i++)
+        if (indices[i] >= dim) {
+            CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+            return RC::INDEX_OUT_OF_BOUND;
+        }
+    RC code = VectorImpl::arrayCheck(CONTEXT, values, count);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    for (size_t i = 0; i < count; i++) {
+        code = addCord(CONTEXT, sparse[indices[i]], values[i]);
+        if (code != RC::SUCCESS) {
+            CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+            return code;
+        }
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+IVector *AccumulatorImpl::snapshot() const {
+    IContext const *const CONTEXT = IContext::current();
+    // Sparse coordinates are the last leaf of merge tree
+    size_t leaves = shards.size() + 1;
+    // Coordinates are merged by blocks, so extra memory doesn't grow with dimension
+    const size_t block = 256;
+    double *sums = new(std::nothrow) double[leaves * block];
+    uint8_t *pInstance = new(std::nothrow) uint8_t[sizeof(VectorImpl) + dim * sizeof(double)];
+    if (sums == nullptr || pInstance == nullptr) {
+        delete[] sums;
+        delete[] pInstance;
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    VectorImpl *res = new(pInstance) VectorImpl(dim);
+    double *data = res->getWritableData();
+
+    RC code = RC::SUCCESS;
+    for (size_t begin = 0; begin < dim && code == RC::SUCCESS; begin += block) {
+        size_t count = dim - begin < block ? dim - begin : block;
+        for (size_t i = 0; i < shards.size(); i++) {
+            std::lock_guard<std::mutex> lock(shards[i]->mutex);
+            std::copy(shards[i]->data + begin, shards[i]->data + begin + count, sums + i * block);
+        }
+        for (size_t j = 0; j < count; j++)
+            sums[shards.size() * block + j] = sparse[begin + j].load(std::memory_order_relaxed);
+
+        // Pairwise merge adds partial sums of similar magnitude, which loses less precision than adding them in a row
+        for (size_t step = 1; step < leaves; step *= 2)
+            for (size_t i = 0; i + step < leaves; i += 2 * step) {
+                double *dest = sums + i * block, *src = sums + (i + step) * block;
+                for (size_t j = 0; j < count; j++)
+                    dest[j] += src[j];
+            }
+
+        code = VectorImpl::arrayCheck(CONTEXT, sums, count);
+        memcpy(data + begin, sums, count * sizeof(double));
+    }
+    delete[] sums;
+    if (code != RC::SUCCESS) {
+        delete res;
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return res;
+}
+
+RC AccumulatorImpl::reset() {
+    IContext const *const CONTEXT = IContext::current();
+    for (size_t i = 0; i < shards.size(); i++) {
+        std::lock_guard<std::mutex> lock(shards[i]->mutex);
+        std::fill(shards[i]->data, shards[i]->data + dim, 0.0);
+    }
+    for (size_t j = 0; j < dim; j++)
+        sparse[j].store(0, std::memory_order_relaxed);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
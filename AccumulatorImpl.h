@@ -0,0 +1,60 @@
+#ifndef VECTOR_ACCUMULATORIMPL_H
+#define VECTOR_ACCUMULATORIMPL_H
+
+#include "IAccumulator.h"
+#include "IContext.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class AccumulatorImpl : public IAccumulator {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    // Every shard starts a cache line and is followed by its coordinates padded to whole lines,
+    // so writers of neighbouring shards never share a line
+    struct alignas(CACHE_LINE) Shard {
+        std::mutex mutex;
+        double *data;
+    };
+
+    size_t dim;
+    std::vector<Shard *> shards;
+    // Block holding every shard and its coordinates, shards start at the first aligned address in it
+    uint8_t *memory;
+    // Target of sparse updates, merged as one more shard
+    std::atomic<double> *sparse;
+
+    Shard &ownShard() const;
+
+    static RC addCord(IContext const *const &context, std::atomic<double> &cord, double val);
+
+    AccumulatorImpl(const AccumulatorImpl &accumulator);
+
+    AccumulatorImpl &operator=(const AccumulatorImpl &accumulator);
+
+public:
+    AccumulatorImpl(size_t dim);
+
+    // Allocates shards and sparse coordinates, accumulator mustn't be used if it fails
+    RC init(size_t shards);
+
+    size_t getDim() const;
+
+    size_t getShards() const;
+
+    RC inc(IVector const *const &op);
+
+    RC inc(size_t index, double val);
+
+    RC inc(size_t const *const &indices, size_t count, double const *const &values);
+
+    IVector *snapshot() const;
+
+    RC reset();
+
+    ~AccumulatorImpl();
+};
+
+#endif //VECTOR_ACCUMULATORIMPL_H
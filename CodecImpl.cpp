@@ -0,0 +1,520 @@
+#include "CodecImpl.h"
+#include "VectorImpl.h"
+#include <cfloat>
+#include <cmath>
+#include <memory.h>
+#include <new>
+
+const char CodecImpl::MAGIC[4] = {'V', 'E', 'C', '1'};
+
+// LZ block format is a sequence of
+// token (4 bits of literal length, 4 bits of match length - MIN_MATCH), literals, 2 bytes of offset
+// Lengths that don't fit into 4 bits continue in following bytes of 255 terminated by a smaller one
+// The last sequence has literals only
+static const size_t MIN_MATCH = 4;
+static const size_t MAX_OFFSET = 65535;
+static const unsigned HASH_LOG = 12;
+
+static inline uint32_t read32(uint8_t const *src) {
+    uint32_t res;
+    memcpy(&res, src, sizeof(res));
+    return res;
+}
+
+static inline uint64_t read64(uint8_t const *src) {
+    uint64_t res;
+    memcpy(&res, src, sizeof(res));
+    return res;
+}
+
+namespace {
+    // Buffer reused by calls of one thread, so coding many vectors doesn't allocate each time
+    // It keeps the size of the largest vector coded by the thread until the thread exits
+    struct Scratch {
+        uint8_t *data;
+        size_t size;
+
+        ~Scratch() {
+            delete[] data;
+        }
+    };
+
+    thread_local Scratch scratch = {nullptr, 0};
+
+    uint8_t *scratchBuffer(size_t size) {
+        if (scratch.size < size) {
+            delete[] scratch.data;
+            scratch.data = new(std::nothrow) uint8_t[size];
+            scratch.size = scratch.data != nullptr ? size : 0;
+        }
+        return scratch.data;
+    }
+}
+
+static inline uint8_t *writeLength(uint8_t *dest, size_t length) {
+    for (; length >= 255; length -= 255)
+        *dest++ = 255;
+    *dest++ = (uint8_t) length;
+    return dest;
+}
+
+CodecImpl::CodecImpl(ENCODING encoding) : encoding(encoding) {}
+
+ICodec::ENCODING CodecImpl::getEncoding() const {
+    return encoding;
+}
+
+size_t CodecImpl::maxEncodedSize(size_t dim) const {
+    switch (encoding) {
+        case ENCODING::SHUFFLE_LZ:
+        case ENCODING::XOR_DELTA:
+            // Incompressible data costs its literal length bytes plus the token
+            return sizeof(Header) + dim * sizeof(double) + dim * sizeof(double) / 255 + 16;
+        case ENCODING::FLOAT32:
+            return sizeof(Header) + dim * sizeof(float);
+        case ENCODING::INT8:
+            return sizeof(Header) + 2 * sizeof(double) + dim;
+        default:
+            return 0;
+    }
+}
+
+// Transposes 8x8 matrix of bytes whose row r is word r, by swapping ever smaller blocks
+static inline void transpose(uint64_t *words) {
+    for (size_t r = 0; r < 4; r++) {
+        uint64_t a = words[r], b = words[r + 4];
+        words[r] = (a & 0x00000000FFFFFFFFull) | (b << 32);
+        words[r + 4] = (a >> 32) | (b & 0xFFFFFFFF00000000ull);
+    }
+    for (size_t r = 0; r < 8; r += (r % 4 == 1) ? 3 : 1) {
+        uint64_t a = words[r], b = words[r + 2];
+        words[r] = (a & 0x0000FFFF0000FFFFull) | ((b & 0x0000FFFF0000FFFFull) << 16);
+        words[r + 2] = ((a >> 16) & 0x0000FFFF0000FFFFull) | (b & 0xFFFF0000FFFF0000ull);
+    }
+    for (size_t r = 0; r < 8; r += 2) {
+        uint64_t a = words[r], b = words[r + 1];
+        words[r] = (a & 0x00FF00FF00FF00FFull) | ((b & 0x00FF00FF00FF00FFull) << 8);
+        words[r + 1] = ((a >> 8) & 0x00FF00FF00FF00FFull) | (b & 0xFF00FF00FF00FF00ull);
+    }
+}
+
+void CodecImpl::shuffle(uint8_t *dest, double const *src, size_t dim, bool delta) {
+    uint64_t words[8], previous = 0;
+    // Eight coordinates at once give eight bytes of every plane
+    for (size_t begin = 0; begin < dim; begin += 8) {
+        size_t count = dim - begin < 8 ? dim - begin : 8;
+        memcpy(words, src + begin, count * sizeof(double));
+        // Neighbouring doubles of slowly varying vector share sign, exponent and high bits of mantissa,
+        // so XOR leaves zeros in high bytes which are gathered together by shuffle
+        if (delta)
+            for (size_t i = 0; i < count; i++) {
+                uint64_t bits = words[i];
+                words[i] ^= previous;
+                previous = bits;
+            }
+        if (count < 8) {
+            for (size_t b = 0; b < sizeof(double); b++)
+                for (size_t i = 0; i < count; i++)
+                    dest[b * dim + begin + i] = (uint8_t) (words[i] >> (8 * b));
+            break;
+        }
+        transpose(words);
+        for (size_t b = 0; b < sizeof(double); b++)
+            memcpy(dest + b * dim + begin, words + b, sizeof(uint64_t));
+    }
+}
+
+void CodecImpl::unshuffle(double *dest, uint8_t const *src, size_t dim, bool delta) {
+    uint64_t words[8], previous = 0;
+    for (size_t begin = 0; begin < dim; begin += 8) {
+        size_t count = dim - begin < 8 ? dim - begin : 8;
+        if (count < 8) {
+            for (size_t i = 0; i < count; i++) {
+                words[i] = 0;
+                for (size_t b = 0; b < sizeof(double); b++)
+                    words[i] |= (uint64_t) src[b * dim + begin + i] << (8 * b);
+            }
+        } else {
+            for (size_t b = 0; b < sizeof(double); b++)
+                memcpy(words + b, src + b * dim + begin, sizeof(uint64_t));
+            transpose(words);
+        }
+        if (delta)
+            for (size_t i = 0; i < count; i++) {
+                previous ^= words[i];
+                words[i] = previous;
+            }
+        memcpy(dest + begin, words, count * sizeof(double));
+    }
+}
+
+size_t CodecImpl::findInvalid(uint8_t const *src, size_t dim, bool delta) {
+    // Exponent lies in the two highest bytes, so only their planes are read
+    uint8_t const *low = src + 6 * dim, *high = src + 7 * dim;
+    const unsigned exponent = 0x7FF0;
+    unsigned previous = 0;
+    if (!delta) {
+        unsigned invalid = 0;
+        for (size_t i = 0; i < dim; i++)
+            invalid |= (((unsigned) high[i] << 8 | low[i]) & exponent) == exponent;
+        if (invalid == 0)
+            return dim;
+    }
+    for (size_t i = 0; i < dim; i++) {
+        unsigned bits = (unsigned) high[i] << 8 | low[i];
+        previous = delta ? previous ^ bits : bits;
+        if ((previous & exponent) == exponent)
+            return i;
+    }
+    return dim;
+}
+
+double CodecImpl::coordinate(uint8_t const *src, size_t dim, bool delta, size_t index) {
+    uint64_t bits = 0;
+    for (size_t i = delta ? 0 : index; i <= index; i++) {
+        uint64_t word = 0;
+        for (size_t b = 0; b < sizeof(double); b++)
+            word |= (uint64_t) src[b * dim + i] << (8 * b);
+        bits = delta ? bits ^ word : word;
+    }
+    double res;
+    memcpy(&res, &bits, sizeof(res));
+    return res;
+}
+
+size_t CodecImpl::lzCompress(uint8_t *dest, size_t capacity, uint8_t const *src, size_t size) {
+    uint32_t table[1 << HASH_LOG];
+    memset(table, 0, sizeof(table));
+    uint8_t *out = dest, *const outEnd = dest + capacity;
+    size_t anchor = 0, pos = 0, misses = 0;
+
+    while (pos + MIN_MATCH <= size) {
+        uint32_t sequence = read32(src + pos);
+        uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_LOG);
+        size_t ref = table[hash];
+        table[hash] = (uint32_t) pos;
+        if (ref >= pos || pos - ref > MAX_OFFSET || read32(src + ref) != sequence) {
+            // Incompressible data is skipped faster the longer no match is found
+            pos += 1 + (misses++ >> 6);
+            continue;
+        }
+        misses = 0;
+
+        size_t length = MIN_MATCH;
+        while (pos + length + sizeof(uint64_t) <= size && read64(src + ref + length) == read64(src + pos + length))
+            length += sizeof(uint64_t);
+        while (pos + length < size && src[ref + length] == src[pos + length])
+            length++;
+
+        size_t literals = pos - anchor;
+        if ((size_t) (outEnd - out) < 1 + literals / 255 + 1 + literals + 2 + (length - MIN_MATCH) / 255 + 1)
+            return 0;
+        uint8_t *token = out++;
+        *token = (uint8_t) ((literals < 15 ? literals : 15) << 4);
+        if (literals >= 15)
+            out = writeLength(out, literals - 15);
+        memcpy(out, src + anchor, literals);
+        out += literals;
+        *out++ = (uint8_t) ((pos - ref) & 0xFF);
+        *out++ = (uint8_t) ((pos - ref) >> 8);
+        size_t extra = length - MIN_MATCH;
+        *token |= (uint8_t) (extra < 15 ? extra : 15);
+        if (extra >= 15)
+            out = writeLength(out, extra - 15);
+
+        pos += length;
+        anchor = pos;
+    }
+
+    size_t literals = size - anchor;
+    if ((size_t) (outEnd - out) < 1 + literals / 255 + 1 + literals)
+        return 0;
+    *out++ = (uint8_t) ((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15)
+        out = writeLength(out, literals - 15);
+    memcpy(out, src + anchor, literals);
+    out += literals;
+    return out - dest;
+}
+
+size_t CodecImpl::lzDecompress(uint8_t *dest, size_t capacity, uint8_t const *src, size_t size) {
+    uint8_t const *in = src, *const inEnd = src + size;
+    uint8_t *out = dest, *const outEnd = dest + capacity;
+
+    while (in < inEnd) {
+        uint8_t token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            uint8_t next;
+            do {
+                if (in >= inEnd)
+                    return 0;
+                next = *in++;
+                literals += next;
+            } while (next == 255);
+        }
+        if ((size_t) (inEnd - in) < literals || (size_t) (outEnd - out) < literals)
+            return 0;
+        memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+        if (in == inEnd)
+            break;
+
+        if (inEnd - in < 2)
+            return 0;
+        size_t offset = in[0] | ((size_t) in[1] << 8);
+        in += 2;
+        size_t length = (token & 0x0F);
+        if (length == 15) {
+            uint8_t next;
+            do {
+                if (in >= inEnd)
+                    return 0;
+                next = *in++;
+                length += next;
+            } while (next == 255);
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > (size_t) (out - dest) || (size_t) (outEnd - out) < length)
+            return 0;
+        // Match may overlap with its own output, words are copied only when they don't overlap
+        uint8_t const *match = out - offset;
+        size_t i = 0;
+        if (offset >= sizeof(uint64_t))
+            for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+                memcpy(out + i, match + i, sizeof(uint64_t));
+        for (; i < length; i++)
+            out[i] = match[i];
+        out += length;
+    }
+    return out - dest;
+}
+
+RC CodecImpl::encodeLossless(IContext const *const &context, double const *data, size_t dim, uint8_t *dest,
+                             size_t capacity, size_t &size) const {
+    uint8_t *shuffled = scratchBuffer(dim * sizeof(double));
+    if (shuffled == nullptr) {
+        context->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    shuffle(shuffled, data, dim, encoding == ENCODING::XOR_DELTA);
+    size = lzCompress(dest, capacity, shuffled, dim * sizeof(double));
+    if (size == 0) {
+        context->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    return RC::SUCCESS;
+}
+
+RC CodecImpl::decompress(IContext const *const &context, uint8_t const *src, size_t size, size_t dim,
+                         uint8_t const *&planes) const {
+    uint8_t *shuffled = scratchBuffer(dim * sizeof(double));
+    if (shuffled == nullptr) {
+        context->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    if (lzDecompress(shuffled, dim * sizeof(double), src, size) != dim * sizeof(double)) {
+        context->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (context->getValidation() == IContext::VALIDATION::FULL) {
+        bool delta = encoding == ENCODING::XOR_DELTA;
+        size_t index = findInvalid(shuffled, dim, delta);
+        if (index < dim)
+            return VectorImpl::elemCheck(context, coordinate(shuffled, dim, delta, index));
+    }
+    planes = shuffled;
+    return RC::SUCCESS;
+}
+
+RC CodecImpl::checkLossy(IContext const *const &context, uint8_t const *src, size_t size, size_t dim) const {
+    if (encoding == ENCODING::FLOAT32) {
+        if (size != dim * sizeof(float))
+            return RC::INVALID_ARGUMENT;
+        if (context->getValidation() == IContext::VALIDATION::NONE)
+            return RC::SUCCESS;
+        const uint32_t exponent = 0x7F800000u;
+        uint32_t invalid = 0;
+        for (size_t i = 0; i < dim; i++)
+            invalid |= (read32(src + i * sizeof(float)) & exponent) == exponent;
+        for (size_t i = 0; invalid != 0 && i < dim; i++) {
+            float value;
+            memcpy(&value, src + i * sizeof(float), sizeof(float));
+            RC code = VectorImpl::elemCheck(context, value);
+            if (code != RC::SUCCESS)
+                return code;
+        }
+        return RC::SUCCESS;
+    }
+    if (size != 2 * sizeof(double) + dim)
+        return RC::INVALID_ARGUMENT;
+    // Coordinates lie between min and min + 255 * step, so they are finite if both ends are
+    double min, step;
+    memcpy(&min, src, sizeof(double));
+    memcpy(&step, src + sizeof(double), sizeof(double));
+    RC code = VectorImpl::elemCheck(context, min);
+    if (code == RC::SUCCESS)
+        code = VectorImpl::elemCheck(context, step);
+    if (code == RC::SUCCESS)
+        code = VectorImpl::elemCheck(context, min + 255 * step);
+    return code;
+}
+
+RC CodecImpl::encode(IVector const *const &src, uint8_t *const &dst, size_t capacity, size_t &size) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (src == nullptr || dst == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    size_t dim = src->getDim();
+    if (capacity < sizeof(Header)) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    double const *data = src->getData();
+    uint8_t *payload = dst + sizeof(Header);
+    size_t payloadCapacity = capacity - sizeof(Header), payloadSize = 0;
+    RC code = RC::SUCCESS;
+
+    switch (encoding) {
+        case ENCODING::SHUFFLE_LZ:
+        case ENCODING::XOR_DELTA:
+            code = encodeLossless(CONTEXT, data, dim, payload, payloadCapacity, payloadSize);
+            break;
+        case ENCODING::FLOAT32: {
+            payloadSize = dim * sizeof(float);
+            if (payloadCapacity < payloadSize) {
+                code = RC::INVALID_ARGUMENT;
+                break;
+            }
+            double max = src->norm(IVector::NORM::CHEBYSHEV);
+            if (max > FLT_MAX) {
+                code = RC::INFINITY_OVERFLOW;
+                break;
+            }
+            for (size_t i = 0; i < dim; i++) {
+                float value = (float) data[i];
+                memcpy(payload + i * sizeof(float), &value, sizeof(float));
+            }
+            break;
+        }
+        case ENCODING::INT8: {
+            payloadSize = 2 * sizeof(double) + dim;
+            if (payloadCapacity < payloadSize) {
+                code = RC::INVALID_ARGUMENT;
+                break;
+            }
+            double min = data[0], max = data[0];
+            for (size_t i = 1; i < dim; i++) {
+                min = data[i] < min ? data[i] : min;
+                max = data[i] > max ? data[i] : max;
+            }
+            double step = (max - min) / 255;
+            if (std::isinf(step)) {
+                code = RC::INFINITY_OVERFLOW;
+                break;
+            }
+            double inverse = step > 0 ? 1 / step : 0;
+            memcpy(payload, &min, sizeof(double));
+            memcpy(payload + sizeof(double), &step, sizeof(double));
+            uint8_t *out = payload + 2 * sizeof(double);
+            for (size_t i = 0; i < dim; i++)
+                out[i] = (uint8_t) ((data[i] - min) * inverse + 0.5);
+            break;
+        }
+        default:
+            code = RC::INVALID_ARGUMENT;
+    }
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.encoding = (uint32_t) encoding;
+    header.dim = dim;
+    header.payload = payloadSize;
+    memcpy(dst, &header, sizeof(header));
+    size = sizeof(header) + payloadSize;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC CodecImpl::decode(uint8_t const *const &src, size_t size, IVector *const dest) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (dest == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    ENCODING found;
+    size_t dim;
+    RC code = inspect(src, size, found, dim);
+    if (code != RC::SUCCESS)
+        return code;
+    if (found != encoding) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (dest->getDim() != dim) {
+        CONTEXT->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    Header header;
+    memcpy(&header, src, sizeof(header));
+    uint8_t const *payload = src + sizeof(header), *planes = nullptr;
+
+    // Payload is checked completely before anything is written, so dest is untouched on failure
+    if (encoding == ENCODING::SHUFFLE_LZ || encoding == ENCODING::XOR_DELTA)
+        code = decompress(CONTEXT, payload, header.payload, dim, planes);
+    else
+        code = checkLossy(CONTEXT, payload, header.payload, dim);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+
+    // Vectors of the library are filled in place, others through a copy
+    VectorImpl *impl = dynamic_cast<VectorImpl *>(dest);
+    double *data = impl != nullptr ? impl->getWritableData() : new(std::nothrow) double[dim];
+    if (data == nullptr) {
+        code = impl != nullptr ? RC::READ_ONLY : RC::ALLOCATION_ERROR;
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    switch (encoding) {
+        case ENCODING::SHUFFLE_LZ:
+        case ENCODING::XOR_DELTA:
+            unshuffle(data, planes, dim, encoding == ENCODING::XOR_DELTA);
+            break;
+        case ENCODING::FLOAT32:
+            for (size_t i = 0; i < dim; i++) {
+                float value;
+                memcpy(&value, payload + i * sizeof(float), sizeof(float));
+                data[i] = value;
+            }
+            break;
+        case ENCODING::INT8: {
+            double min, step;
+            memcpy(&min, payload, sizeof(double));
+            memcpy(&step, payload + sizeof(double), sizeof(double));
+            uint8_t const *in = payload + 2 * sizeof(double);
+            for (size_t i = 0; i < dim; i++)
+                data[i] = min + in[i] * step;
+            break;
+        }
+        default:
+            break;
+    }
+    if (impl == nullptr) {
+        code = dest->setData(dim, data);
+        delete[] data;
+        if (code != RC::SUCCESS) {
+            CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+            return code;
+        }
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
@@ -0,0 +1,62 @@
+#ifndef VECTOR_CODECIMPL_H
+#define VECTOR_CODECIMPL_H
+
+#include "ICodec.h"
+#include "IContext.h"
+
+class CodecImpl : public ICodec {
+private:
+    ENCODING encoding;
+
+    // Puts byte b of every coordinate into plane b, coordinates are XORed with previous ones first if delta is set
+    static void shuffle(uint8_t *dest, double const *src, size_t dim, bool delta);
+
+    static void unshuffle(double *dest, uint8_t const *src, size_t dim, bool delta);
+
+    // Index of the first infinite or NaN coordinate in shuffled planes, dim if there is none
+    static size_t findInvalid(uint8_t const *src, size_t dim, bool delta);
+
+    static double coordinate(uint8_t const *src, size_t dim, bool delta, size_t index);
+
+    static size_t lzCompress(uint8_t *dest, size_t capacity, uint8_t const *src, size_t size);
+
+    static size_t lzDecompress(uint8_t *dest, size_t capacity, uint8_t const *src, size_t size);
+
+    RC encodeLossless(IContext const *const &context, double const *data, size_t dim, uint8_t *dest,
+                      size_t capacity, size_t &size) const;
+
+    // Decompresses payload into scratch buffer of calling thread and checks coordinates it holds
+    RC decompress(IContext const *const &context, uint8_t const *src, size_t size, size_t dim,
+                  uint8_t const *&planes) const;
+
+    // Checks payload of lossy encodings before anything is written
+    RC checkLossy(IContext const *const &context, uint8_t const *src, size_t size, size_t dim) const;
+
+    CodecImpl(const CodecImpl &codec);
+
+    CodecImpl &operator=(const CodecImpl &codec);
+
+public:
+    struct Header {
+        char magic[4];
+        uint32_t encoding;
+        uint64_t dim;
+        uint64_t payload; // Size of encoded data following the header
+    };
+
+    static const char MAGIC[4];
+
+    CodecImpl(ENCODING encoding);
+
+    ENCODING getEncoding() const;
+
+    size_t maxEncodedSize(size_t dim) const;
+
+    RC encode(IVector const *const &src, uint8_t *const &dst, size_t capacity, size_t &size) const;
+
+    RC decode(uint8_t const *const &src, size_t size, IVector *const dest) const;
+
+    ~CodecImpl() {};
+};
+
+#endif //VECTOR_CODECIMPL_H
@@ -0,0 +1,42 @@
+#include "ContextImpl.h"
+
+ContextImpl::ContextImpl(ILogger *const logger, ILogger::Level threshold, VALIDATION validation)
+        : logger(logger), threshold(threshold), validation(validation) {}
+
+ILogger *ContextImpl::getLogger() const {
+    return logger.load(std::memory_order_acquire);
+}
+
+RC ContextImpl::setLogger(ILogger *const logger) {
+    this->logger.store(logger, std::memory_order_release);
+    return RC::SUCCESS;
+}
+
+ILogger::Level ContextImpl::getThreshold() const {
+    return threshold.load(std::memory_order_relaxed);
+}
+
+RC ContextImpl::setThreshold(ILogger::Level threshold) {
+    this->threshold.store(threshold, std::memory_order_relaxed);
+    return RC::SUCCESS;
+}
+
+IContext::VALIDATION ContextImpl::getValidation() const {
+    return validation.load(std::memory_order_relaxed);
+}
+
+RC ContextImpl::setValidation(VALIDATION validation) {
+    this->validation.store(validation, std::memory_order_relaxed);
+    return RC::SUCCESS;
+}
+
+RC ContextImpl::log(RC code, ILogger::Level level, const char *const &srcfile, const char *const &function,
+                    int line) const {
+    // Levels are ordered from SEVERE to INFO, so greater level is more verbose
+    if (level > threshold.load(std::memory_order_relaxed))
+        return RC::SUCCESS;
+    ILogger *const current = logger.load(std::memory_order_acquire);
+    if (current == nullptr)
+        return RC::SUCCESS;
+    return current->log(code, level, srcfile, function, line);
+}
@@ -0,0 +1,37 @@
+#ifndef VECTOR_CONTEXTIMPL_H
+#define VECTOR_CONTEXTIMPL_H
+
+#include "IContext.h"
+#include <atomic>
+
+class ContextImpl : public IContext {
+private:
+    std::atomic<ILogger *> logger;
+    std::atomic<ILogger::Level> threshold;
+    std::atomic<VALIDATION> validation;
+
+    ContextImpl(const ContextImpl &context);
+
+    ContextImpl &operator=(const ContextImpl &context);
+
+public:
+    ContextImpl(ILogger *const logger, ILogger::Level threshold, VALIDATION validation);
+
+    ILogger *getLogger() const;
+
+    RC setLogger(ILogger *const logger);
+
+    ILogger::Level getThreshold() const;
+
+    RC setThreshold(ILogger::Level threshold);
+
+    VALIDATION getValidation() const;
+
+    RC setValidation(VALIDATION validation);
+
+    RC log(RC code, ILogger::Level level, const char *const &srcfile, const char *const &function, int line) const;
+
+    ~ContextImpl() {};
+};
+
+#endif //VECTOR_CONTEXTIMPL_H
@@ -0,0 +1,26 @@
+#include "AccumulatorImpl.h"
+#include <new>
+#include <thread>
+
+IAccumulator *IAccumulator::createAccumulator(size_t dim, size_t shards) {
+    IContext const *const CONTEXT = IContext::current();
+    if (dim == 0) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    if (shards == 0)
+        shards = std::thread::hardware_concurrency();
+    if (shards == 0)
+        shards = 1;
+    AccumulatorImpl *accumulator = new(std::nothrow) AccumulatorImpl(dim);
+    if (accumulator == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    if (accumulator->init(shards) != RC::SUCCESS) {
+        delete accumulator;
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return (IAccumulator *) accumulator;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Sum of vectors added concurrently by many threads
+*
+* Every thread adds into one of several shards, so writers rarely contend, shards are merged
+* pairwise only when sum is read
+*/
+class LIB_EXPORT IAccumulator {
+public:
+    // @param [in] shards Amount of partial sums, 0 means amount of hardware threads
+    static IAccumulator *createAccumulator(size_t dim, size_t shards = 0);
+
+    virtual size_t getDim() const = 0;
+
+    virtual size_t getShards() const = 0;
+
+    /*
+    * Adds op into shard of calling thread, fails leaving shard untouched if any coordinate of it overflows
+    */
+    virtual RC inc(IVector const *const &op) = 0;
+
+    /*
+    * Sparse updates go straight into shared coordinates with compare-and-swap, no lock is taken
+    *
+    * If some coordinate would overflow, it stays untouched and call fails, coordinates preceding it stay updated
+    */
+    virtual RC inc(size_t index, double val) = 0;
+
+    virtual RC inc(size_t const *const &indices, size_t count, double const *const &values) = 0;
+
+    /*
+    * Ordinary vector holding the sum, nullptr with INFINITY_OVERFLOW logged if sum overflows
+    *
+    * Shards are read by blocks of coordinates, so an addition made while snapshot is taken may be seen partially
+    */
+    virtual IVector *snapshot() const = 0;
+
+    // Sets sum to zero, must not run concurrently with additions
+    virtual RC reset() = 0;
+
+    virtual ~IAccumulator() = 0;
+
+private:
+    IAccumulator(const IAccumulator &accumulator) = delete;
+
+    IAccumulator &operator=(const IAccumulator &accumulator) = delete;
+
+protected:
+    IAccumulator() = default;
+};
+
+inline IAccumulator::~IAccumulator() {};
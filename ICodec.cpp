@@ -0,0 +1,53 @@
+#include "CodecImpl.h"
+#include <cmath>
+#include <memory.h>
+#include <new>
+
+ICodec *ICodec::createCodec(ENCODING encoding) {
+    IContext const *const CONTEXT = IContext::current();
+    if (encoding >= ENCODING::AMOUNT) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    ICodec *codec = (ICodec *) new(std::nothrow) CodecImpl(encoding);
+    if (codec == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return codec;
+}
+
+RC ICodec::inspect(uint8_t const *const &src, size_t size, ENCODING &encoding, size_t &dim) {
+    IContext const *const CONTEXT = IContext::current();
+    if (src == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    CodecImpl::Header header;
+    if (size < sizeof(header)) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    memcpy(&header, src, sizeof(header));
+    if (memcmp(header.magic, CodecImpl::MAGIC, sizeof(header.magic)) != 0 ||
+        header.encoding >= (uint32_t) ENCODING::AMOUNT || header.dim == 0 ||
+        header.payload > size - sizeof(header)) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    encoding = (ENCODING) header.encoding;
+    dim = header.dim;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+double ICodec::ratio(uint8_t const *const &src, size_t size) {
+    ENCODING encoding;
+    size_t dim;
+    if (inspect(src, size, encoding, dim) != RC::SUCCESS)
+        return NAN;
+    CodecImpl::Header header;
+    memcpy(&header, src, sizeof(header));
+    return (double) (dim * sizeof(double)) / (double) (sizeof(header) + header.payload);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Compact encodings of vectors for files and network
+*
+* Encoded vector starts with a header keeping encoding and dimension, numbers are stored in host byte order
+*/
+class LIB_EXPORT ICodec {
+public:
+    enum class ENCODING {
+        SHUFFLE_LZ, // Lossless: bytes of doubles are grouped by significance and compressed by LZ
+        XOR_DELTA,  // Lossless: each double is XORed with previous one before SHUFFLE_LZ, for slowly varying data
+        FLOAT32,    // Lossy: coordinates are rounded to float
+        INT8,       // Lossy: coordinates are quantized into 256 levels between minimum and maximum
+        AMOUNT
+    };
+
+    static ICodec *createCodec(ENCODING encoding);
+
+    virtual ENCODING getEncoding() const = 0;
+
+    /*
+    * Size of buffer enough to encode any vector of given dimension
+    */
+    virtual size_t maxEncodedSize(size_t dim) const = 0;
+
+    /*
+    * @param [in] dst Buffer for encoded vector
+    *
+    * @param [in] capacity Size of dst in bytes
+    *
+    * @param [out] size Amount of bytes written into dst
+    */
+    virtual RC encode(IVector const *const &src, uint8_t *const &dst, size_t capacity, size_t &size) const = 0;
+
+    /*
+    * Decodes vector into existing one of the same dimension without allocating new vector
+    *
+    * Coordinates are written in place once the whole payload is checked, so dest is untouched on failure
+    * Lossless encodings reuse scratch buffer of calling thread, which keeps size of the largest vector coded by it
+    */
+    virtual RC decode(uint8_t const *const &src, size_t size, IVector *const dest) const = 0;
+
+    /*
+    * Reads header of encoded vector
+    */
+    static RC inspect(uint8_t const *const &src, size_t size, ENCODING &encoding, size_t &dim);
+
+    /*
+    * Size of raw doubles divided by size of encoded vector, NAN if src is not an encoded vector
+    */
+    static double ratio(uint8_t const *const &src, size_t size);
+
+    virtual ~ICodec() = 0;
+
+private:
+    ICodec(const ICodec &codec) = delete;
+
+    ICodec &operator=(const ICodec &codec) = delete;
+
+protected:
+    ICodec() = default;
+};
+
+inline ICodec::~ICodec() {};
@@ -0,0 +1,36 @@
+#include "ContextImpl.h"
+#include <new>
+
+namespace {
+    ContextImpl &builtinContext() {
+        static ContextImpl context(nullptr, ILogger::Level::INFO, IContext::VALIDATION::FULL);
+        return context;
+    }
+
+    std::atomic<IContext *> defaultContext(nullptr);
+
+    thread_local IContext *boundContext = nullptr;
+}
+
+IContext *IContext::createContext(ILogger *const logger, ILogger::Level threshold, VALIDATION validation) {
+    return (IContext *) new(std::nothrow) ContextImpl(logger, threshold, validation);
+}
+
+IContext *IContext::getDefault() {
+    IContext *context = defaultContext.load(std::memory_order_acquire);
+    return context != nullptr ? context : &builtinContext();
+}
+
+RC IContext::setDefault(IContext *const context) {
+    defaultContext.store(context, std::memory_order_release);
+    return RC::SUCCESS;
+}
+
+RC IContext::bind(IContext *const context) {
+    boundContext = context;
+    return RC::SUCCESS;
+}
+
+IContext *IContext::current() {
+    return boundContext != nullptr ? boundContext : getDefault();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "RC.h"
+#include "ILogger.h"
+#include "Interfacedllexport.h"
+
+/*
+* Execution context of vector operations
+*
+* Carries logger, log threshold and validation policy, so independent tenants of one process
+* don't have to share a single global logger
+*
+* Every operation resolves its context once: the one bound to the calling thread if any,
+* otherwise the process-wide default
+*/
+class LIB_EXPORT IContext {
+public:
+    enum class VALIDATION {
+        FULL, // Every incoming and produced element is checked for infinity and NaN
+        NONE  // Caller guarantees finite data, checks are skipped
+    };
+
+    /*
+    * @param [in] logger Logger of the context, nullptr disables logging
+    *
+    * @param [in] threshold Most verbose level that is still passed to logger
+    *
+    * @param [in] validation Policy of element checks
+    */
+    static IContext *createContext(ILogger *const logger = nullptr, ILogger::Level threshold = ILogger::Level::INFO,
+                                   VALIDATION validation = VALIDATION::FULL);
+
+    /*
+    * Context used by threads without bound context, never nullptr
+    */
+    static IContext *getDefault();
+
+    /*
+    * Atomically publishes new default context, nullptr restores built-in one
+    *
+    * Previous default context is not deleted and must outlive operations that could still use it
+    */
+    static RC setDefault(IContext *const context);
+
+    /*
+    * Binds context to the calling thread, nullptr unbinds it
+    */
+    static RC bind(IContext *const context);
+
+    /*
+    * Context bound to the calling thread or default one
+    */
+    static IContext *current();
+
+    virtual ILogger *getLogger() const = 0;
+
+    virtual RC setLogger(ILogger *const logger) = 0;
+
+    virtual ILogger::Level getThreshold() const = 0;
+
+    virtual RC setThreshold(ILogger::Level threshold) = 0;
+
+    virtual VALIDATION getValidation() const = 0;
+
+    virtual RC setValidation(VALIDATION validation) = 0;
+
+    /*
+    * Passes record to logger of the context if there is one and level is not filtered by threshold
+    */
+    virtual RC log(RC code, ILogger::Level level, const char *const &srcfile, const char *const &function,
+                   int line) const = 0;
+
+    RC severe(RC code, const char *const &srcfile, const char *const &function, int line) const {
+        return log(code, ILogger::Level::SEVERE, srcfile, function, line);
+    };
+
+    RC warning(RC code, const char *const &srcfile, const char *const &function, int line) const {
+        return log(code, ILogger::Level::WARNING, srcfile, function, line);
+    };
+
+    RC info(RC code, const char *const &srcfile, const char *const &function, int line) const {
+        return log(code, ILogger::Level::INFO, srcfile, function, line);
+    };
+
+    virtual ~IContext() = 0;
+
+private:
+    IContext(const IContext &context) = delete;
+
+    IContext &operator=(const IContext &context) = delete;
+
+protected:
+    IContext() = default;
+};
+
+inline IContext::~IContext() {};
@@ -0,0 +1,17 @@
+#include "JobQueueImpl.h"
+#include <new>
+
+IJobQueue *IJobQueue::createJobQueue(size_t workers) {
+    IContext const *const CONTEXT = IContext::current();
+    if (workers == 0)
+        workers = std::thread::hardware_concurrency();
+    if (workers == 0)
+        workers = 1;
+    IJobQueue *queue = (IJobQueue *) new(std::nothrow) JobQueueImpl(workers);
+    if (queue == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return queue;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Asynchronous executor of batches of vector operations
+*
+* Batch is split into chunks run by a pool of workers, jobs sharing an operand are grouped
+* into one chunk whenever possible to reuse it while it is still in cache
+*
+* Jobs of one batch must be independent: none of them may write into a vector another one reads or writes
+*/
+class LIB_EXPORT IJobQueue {
+public:
+    enum class OPERATION {
+        DOT,   // result = dot(op1, op2)
+        NORM,  // result = op1->norm(norm)
+        ADD,   // dest = op1 + op2
+        SUB,   // dest = op1 - op2
+        SCALE, // dest *= multiplier
+        AMOUNT
+    };
+
+    struct Job {
+        OPERATION operation;
+        IVector const *op1;
+        IVector const *op2;
+        IVector *dest;
+        IVector::NORM norm;
+        double multiplier;
+
+        // Filled by the queue when the job is done
+        double result;
+        RC code;
+    };
+
+    /*
+    * @param [in] workers Amount of worker threads, 0 means one per hardware thread
+    */
+    static IJobQueue *createJobQueue(size_t workers = 0);
+
+    /*
+    * Enqueues batch and returns immediately
+    *
+    * Jobs must stay alive until the batch is complete
+    *
+    * @return Future of SUCCESS if every job succeeded, otherwise of code of first failed one
+    */
+    virtual std::future<RC> submit(Job *const &jobs, size_t count) = 0;
+
+    /*
+    * Same as submit() but calls callback from worker thread once the batch is complete
+    */
+    virtual RC submit(Job *const &jobs, size_t count, const std::function<void(RC)> &callback) = 0;
+
+    virtual size_t getWorkers() const = 0;
+
+    /*
+    * Finishes every submitted batch before returning
+    */
+    virtual ~IJobQueue() = 0;
+
+private:
+    IJobQueue(const IJobQueue &queue) = delete;
+
+    IJobQueue &operator=(const IJobQueue &queue) = delete;
+
+protected:
+    IJobQueue() = default;
+};
+
+inline IJobQueue::~IJobQueue() {};
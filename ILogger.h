@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "RC.h"
 #include "Interfacedllexport.h"
 
@@ -103,6 +104,39 @@ public:
         return log(code, Level::INFO);
     };
 
+    /*
+    * Throttling is optional for implementations, by default these calls are accepted and ignored
+    *
+    * Records of every call site are throttled within windows of given length, 1000 ms by default
+    *
+    * Records dropped by sampling or rate limit are reported by one line with their count when window ends
+    */
+    virtual RC setWindow(size_t /*milliseconds*/) {
+        return RC::SUCCESS;
+    };
+
+    /*
+    * @param [in] probability Share of records of given level that are written, 1 by default
+    */
+    virtual RC setSampling(Level /*level*/, double /*probability*/) {
+        return RC::SUCCESS;
+    };
+
+    /*
+    * @param [in] records Most records of given level written from one call site within window, 0 means unlimited
+    * Set 1 to coalesce repeated records into a single line with count
+    */
+    virtual RC setRateLimit(Level /*level*/, size_t /*records*/) {
+        return RC::SUCCESS;
+    };
+
+    /*
+    * Writes pending counts of dropped records
+    */
+    virtual RC flush() {
+        return RC::SUCCESS;
+    };
+
     virtual ~ILogger() = 0;
 
 private:
@@ -0,0 +1,106 @@
+#include "SegmentImpl.h"
+#include <vector>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ISegment *ISegment::createSegment(char const *const &name, size_t count, size_t const *const &dims) {
+    IContext const *const CONTEXT = IContext::current();
+    if (name == nullptr || dims == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    for (size_t i = 0; i < count; i++)
+        if (dims[i] == 0) {
+            CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+            return nullptr;
+        }
+    return SegmentImpl::create(name, count, dims, nullptr);
+}
+
+ISegment *ISegment::createSegment(char const *const &name, size_t count, IVector const *const *const &vectors) {
+    IContext const *const CONTEXT = IContext::current();
+    if (name == nullptr || vectors == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    std::vector<size_t> dims(count);
+    for (size_t i = 0; i < count; i++) {
+        if (vectors[i] == nullptr) {
+            CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return nullptr;
+        }
+        dims[i] = vectors[i]->getDim();
+    }
+    return SegmentImpl::create(name, count, dims.data(), vectors);
+}
+
+ISegment *ISegment::attachSegment(char const *const &name, MODE mode) {
+    IContext const *const CONTEXT = IContext::current();
+    if (name == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    bool readOnly = mode == MODE::READ_ONLY;
+    int fd = shm_open(name, readOnly ? O_RDONLY : O_RDWR, 0);
+    if (fd < 0) {
+        RC code = errno == ENOENT ? RC::FILE_NOT_FOUND : RC::IO_ERROR;
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        mapped = mmap(nullptr, (size_t) info.st_size, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                      0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        CONTEXT->warning(RC::IO_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    size_t size = (size_t) info.st_size;
+    if (SegmentImpl::validate((uint8_t const *) mapped, size) != RC::SUCCESS) {
+        munmap(mapped, size);
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    ISegment *segment = (ISegment *) new(std::nothrow) SegmentImpl((uint8_t *) mapped, size, mode);
+    if (segment == nullptr) {
+        munmap(mapped, size);
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return segment;
+#else
+    CONTEXT->warning(RC::IO_ERROR, __FILE__, __func__, __LINE__);
+    return nullptr;
+#endif
+}
+
+RC ISegment::removeSegment(char const *const &name) {
+    IContext const *const CONTEXT = IContext::current();
+    if (name == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    if (shm_unlink(name) != 0) {
+        RC code = errno == ENOENT ? RC::FILE_NOT_FOUND : RC::IO_ERROR;
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+#else
+    CONTEXT->warning(RC::IO_ERROR, __FILE__, __func__, __LINE__);
+    return RC::IO_ERROR;
+#endif
+}
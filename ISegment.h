@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Collection of vectors placed in named shared memory, so that several processes work with one copy
+*
+* Segment refers to its vectors by offsets, so it may be mapped at any address
+* Available on POSIX systems only, elsewhere factories return nullptr
+*/
+class LIB_EXPORT ISegment {
+public:
+    enum class MODE {
+        READ_ONLY, // Vectors reject every change with RC::READ_ONLY
+        READ_WRITE
+    };
+
+    /*
+    * Creates segment of zero vectors, fails with VECTOR_ALREADY_EXIST if segment with such name exists
+    *
+    * @param [in] name Name of shared memory object, "/name" form is portable
+    *
+    * @param [in] dims Dimensions of count vectors
+    */
+    static ISegment *createSegment(char const *const &name, size_t count, size_t const *const &dims);
+
+    /*
+    * Same as createSegment() but vectors are copies of given ones
+    */
+    static ISegment *createSegment(char const *const &name, size_t count, IVector const *const *const &vectors);
+
+    static ISegment *attachSegment(char const *const &name, MODE mode);
+
+    /*
+    * Removes name of segment, memory is released once every process detaches from it
+    */
+    static RC removeSegment(char const *const &name);
+
+    virtual size_t getCount() const = 0;
+
+    virtual MODE getMode() const = 0;
+
+    /*
+    * Vector viewing coordinates inside segment without copying them, it must be deleted before segment
+    *
+    * Changes made by other processes are seen immediately, vector doesn't cache norms
+    */
+    virtual IVector *getVector(size_t index) const = 0;
+
+    /*
+    * Unmaps segment from current process
+    */
+    virtual ~ISegment() = 0;
+
+private:
+    ISegment(const ISegment &segment) = delete;
+
+    ISegment &operator=(const ISegment &segment) = delete;
+
+protected:
+    ISegment() = default;
+};
+
+inline ISegment::~ISegment() {};
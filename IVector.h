@@ -22,6 +22,33 @@ public:
         AMOUNT
     };
 
+    enum class ORDER {
+        ASCENDING,
+        DESCENDING
+    };
+
+    // Fields of Stats, combined into mask to request only needed ones
+    enum STAT {
+        STAT_SUM = 1 << 0,
+        STAT_MEAN = 1 << 1,
+        STAT_MIN = 1 << 2,
+        STAT_MAX = 1 << 3,
+        STAT_ARGMIN = 1 << 4, // Index of first minimal coordinate
+        STAT_ARGMAX = 1 << 5, // Index of first maximal coordinate
+        STAT_VARIANCE = 1 << 6, // Population variance
+        STAT_ALL = (1 << 7) - 1
+    };
+
+    struct Stats {
+        double sum;
+        double mean;
+        double min;
+        double max;
+        size_t argmin;
+        size_t argmax;
+        double variance;
+    };
+
     static IVector *createVector(size_t dim, double const *const &ptr_data);
 
     static RC copyInstance(IVector *const dest, IVector const *const &src);
@@ -41,6 +68,25 @@ public:
 
     virtual RC setCord(size_t index, double val) = 0;
 
+    /*
+    * Bulk accessors check bounds and elements once per call instead of once per coordinate
+    */
+    virtual RC getRange(size_t begin, size_t count, double *const &dst) const = 0;
+
+    virtual RC setRange(size_t begin, size_t count, double const *const &src) = 0;
+
+    virtual RC gather(size_t const *const &indices, size_t count, double *const &dst) const = 0;
+
+    // If index repeats, the last value is kept
+    virtual RC scatter(size_t const *const &indices, size_t count, double const *const &src) = 0;
+
+    /*
+    * Vector of coordinates [begin, begin + count) sharing memory with this one
+    *
+    * Changes made through view are seen by vector and vice versa, view must be deleted before vector
+    */
+    virtual IVector *view(size_t begin, size_t count) = 0;
+
     virtual RC scale(double multiplier) = 0;
 
     virtual size_t getDim() const = 0;
@@ -57,14 +103,64 @@ public:
 
     static bool equals(IVector const *const &op1, IVector const *const &op2, NORM n, double tol);
 
+    // Cosine of angle between vectors, uses norms cached by vectors
+    static double cosine(IVector const *const &op1, IVector const *const &op2);
+
+    // Norms are cached until vector changes
     virtual double norm(NORM n) const = 0;
 
     virtual RC applyFunction(const std::function<double(double)> &fun) = 0;
 
     virtual RC foreach(const std::function<void(double)> &fun) const = 0;
 
+    /*
+    * Computes requested statistics in a single pass, fields not requested by mask are left untouched
+    */
+    virtual RC stats(Stats &res, unsigned mask = STAT_ALL) const = 0;
+
+    /*
+    * Selects k smallest (ASCENDING) or largest (DESCENDING) coordinates in O(dim log k) without allocations
+    *
+    * @param [out] indices, values Buffers of k elements receiving coordinates sorted in given order,
+    * equal coordinates are ordered by index
+    */
+    virtual RC topK(size_t k, ORDER order, size_t *const &indices, double *const &values) const = 0;
+
+    // @param [out] indices Buffer of dim elements receiving indices of coordinates sorted in given order
+    virtual RC argsort(size_t *const &indices, ORDER order = ORDER::ASCENDING) const = 0;
+
+    /*
+    * Quantile of level q from [0, 1], interpolated linearly between neighbouring order statistics
+    *
+    * Selection reorders a copy of coordinates, which is allocated on every call
+    */
+    virtual RC quantile(double q, double &val) const = 0;
+
+    // Same as quantile() but the copy is made in scratch buffer of dim elements, so nothing is allocated
+    virtual RC quantile(double q, double &val, double *const &scratch) const = 0;
+
+    // Size of instance and all memory reserved for its coordinates
     virtual size_t sizeAllocated() const = 0;
 
+    /*
+    * Vector grows geometrically, so appending n coordinates one by one costs O(n)
+    *
+    * Growing vector moves its coordinates, so views and pointers returned by getData() become invalid
+    * Views themselves can't change their dimension
+    */
+    virtual size_t getCapacity() const = 0;
+
+    virtual RC reserve(size_t capacity) = 0;
+
+    virtual RC pushBack(double val) = 0;
+
+    virtual RC append(size_t count, double const *const &src) = 0;
+
+    // New coordinates are set to val
+    virtual RC resize(size_t dim, double val = 0) = 0;
+
+    virtual RC shrinkToFit() = 0;
+
     virtual ~IVector() = 0;
 
 private:
@@ -75,3 +171,5 @@ private:
 protected:
     IVector() = default;
 };
+
+inline IVector::~IVector() {};
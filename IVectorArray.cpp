@@ -0,0 +1,21 @@
+#include "VectorArrayImpl.h"
+#include <new>
+
+IVectorArray *IVectorArray::createVectorArray(size_t dim, size_t capacity) {
+    IContext const *const CONTEXT = IContext::current();
+    if (dim == 0) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    VectorArrayImpl *array = new(std::nothrow) VectorArrayImpl(dim);
+    if (array == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    if (array->reserve(capacity) != RC::SUCCESS) {
+        delete array;
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return (IVectorArray *) array;
+}
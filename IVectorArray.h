@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Array of vectors of one dimension stored as structure of arrays: coordinate i of every vector
+* lies in its own contiguous array
+*
+* Vectors have no header of their own, and bulk operations loop across vectors instead of coordinates,
+* so they suit millions of low-dimensional vectors such as points of a cloud
+*/
+class LIB_EXPORT IVectorArray {
+public:
+    static IVectorArray *createVectorArray(size_t dim, size_t capacity = 0);
+
+    virtual size_t getDim() const = 0;
+
+    // Amount of vectors in array
+    virtual size_t getSize() const = 0;
+
+    /*
+    * Array grows geometrically, so pushing n vectors one by one costs O(n)
+    *
+    * Growing array moves coordinates, so pointers returned by getCords() become invalid
+    */
+    virtual size_t getCapacity() const = 0;
+
+    virtual RC reserve(size_t capacity) = 0;
+
+    // @param [in] cords Coordinates of vector, dim elements
+    virtual RC pushBack(double const *const &cords) = 0;
+
+    virtual RC pushBack(IVector const *const &vector) = 0;
+
+    virtual RC clear() = 0;
+
+    virtual RC get(size_t index, double *const &cords) const = 0;
+
+    virtual RC set(size_t index, double const *const &cords) = 0;
+
+    // Copy of vector at index
+    virtual IVector *getVector(size_t index) const = 0;
+
+    // Contiguous array of size elements holding coordinate axis of every vector
+    virtual double const *getCords(size_t axis) const = 0;
+
+    /*
+    * Bulk operations change either every vector or none of them
+    */
+    // Adds op to every vector
+    virtual RC add(IVector const *const &op) = 0;
+
+    virtual RC scale(double multiplier) = 0;
+
+    /*
+    * @param [out] res Buffer of size elements receiving result for every vector
+    */
+    virtual RC dot(IVector const *const &query, double *const &res) const = 0;
+
+    virtual RC norm(IVector::NORM n, double *const &res) const = 0;
+
+    /*
+    * Selects vectors equal to query in the sense of IVector::equals()
+    *
+    * @param [out] indices Buffer of size elements receiving ascending indices of selected vectors
+    *
+    * @param [out] count Amount of selected vectors
+    */
+    virtual RC equals(IVector const *const &query, IVector::NORM n, double tol, size_t *const &indices,
+                      size_t &count) const = 0;
+
+    // Size of instance and all memory reserved for coordinates
+    virtual size_t sizeAllocated() const = 0;
+
+    virtual ~IVectorArray() = 0;
+
+private:
+    IVectorArray(const IVectorArray &array) = delete;
+
+    IVectorArray &operator=(const IVectorArray &array) = delete;
+
+protected:
+    IVectorArray() = default;
+};
+
+inline IVectorArray::~IVectorArray() {};
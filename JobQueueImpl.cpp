@@ -0,0 +1,243 @@
+#include "JobQueueImpl.h"
+#include "VectorImpl.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+// Smallest amount of jobs handed to one worker at once, smaller chunks cost more in dispatch than they gain
+static const size_t MIN_CHUNK = 64;
+
+// Sums are checked by blocks of that many coordinates before anything is written
+static const size_t SUM_BLOCK = 256;
+
+namespace {
+    // Buffer reused by jobs run on one worker, needed only when dest partially overlaps an operand
+    struct Scratch {
+        double *data;
+        size_t size;
+
+        ~Scratch() {
+            delete[] data;
+        }
+    };
+
+    thread_local Scratch scratch = {nullptr, 0};
+
+    double *scratchBuffer(size_t size) {
+        if (scratch.size < size) {
+            delete[] scratch.data;
+            scratch.data = new(std::nothrow) double[size];
+            scratch.size = scratch.data != nullptr ? size : 0;
+        }
+        return scratch.data;
+    }
+
+    // Coordinate i of result depends only on coordinates i of operands, so dest may coincide with them
+    bool overlaps(double const *dest, double const *op, size_t dim) {
+        return dest != op && std::less<double const *>()(op, dest + dim) && std::less<double const *>()(dest, op + dim);
+    }
+}
+
+JobQueueImpl::JobQueueImpl(size_t workers) : stopping(false) {
+    for (size_t i = 0; i < workers; i++)
+        this->workers.push_back(std::thread(&JobQueueImpl::work, this));
+}
+
+JobQueueImpl::~JobQueueImpl() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+size_t JobQueueImpl::getWorkers() const {
+    return workers.size();
+}
+
+RC JobQueueImpl::doJob(Job &job) {
+    if (job.operation == OPERATION::SCALE) {
+        if (job.dest == nullptr)
+            return RC::NULLPTR_ERROR;
+        return job.dest->scale(job.multiplier);
+    }
+    if (job.op1 == nullptr)
+        return RC::NULLPTR_ERROR;
+    if (job.operation == OPERATION::NORM) {
+        job.result = job.op1->norm(job.norm);
+        return std::isnan(job.result) ? RC::INVALID_ARGUMENT : RC::SUCCESS;
+    }
+    if (job.op2 == nullptr)
+        return RC::NULLPTR_ERROR;
+    if (job.op1->getDim() != job.op2->getDim())
+        return RC::MISMATCHING_DIMENSIONS;
+
+    switch (job.operation) {
+        case OPERATION::DOT:
+            job.result = IVector::dot(job.op1, job.op2);
+            return RC::SUCCESS;
+        case OPERATION::ADD:
+        case OPERATION::SUB: {
+            bool minus = job.operation == OPERATION::SUB;
+            if (job.dest == nullptr)
+                return RC::NULLPTR_ERROR;
+            // x - x and x + x need no scratch, scale() leaves x untouched on failure
+            if (job.dest == job.op1 && job.op1 == job.op2)
+                return job.dest->scale(minus ? 0 : 2);
+            return doSum(job, minus);
+        }
+        default:
+            return RC::INVALID_ARGUMENT;
+    }
+}
+
+RC JobQueueImpl::doSum(Job &job, bool minus) {
+    IContext const *const CONTEXT = IContext::current();
+    size_t dim = job.op1->getDim();
+    if (job.dest->getDim() != dim)
+        return RC::MISMATCHING_DIMENSIONS;
+    double const *one = job.op1->getData(), *two = job.op2->getData(), *target = job.dest->getData();
+    double sign = minus ? -1 : 1;
+
+    // Vectors of the library are written in place unless dest is shifted against an operand,
+    // others get the result through setData()
+    VectorImpl *impl = dynamic_cast<VectorImpl *>(job.dest);
+    if (impl == nullptr || overlaps(target, one, dim) || overlaps(target, two, dim)) {
+        double *sum = scratchBuffer(dim);
+        if (sum == nullptr)
+            return RC::ALLOCATION_ERROR;
+        for (size_t i = 0; i < dim; i++)
+            sum[i] = one[i] + sign * two[i];
+        return job.dest->setData(dim, sum);
+    }
+
+    // Sums are checked before anything is written, so dest is untouched on failure
+    if (CONTEXT->getValidation() == IContext::VALIDATION::FULL) {
+        double sum[SUM_BLOCK];
+        for (size_t begin = 0; begin < dim; begin += SUM_BLOCK) {
+            size_t count = dim - begin < SUM_BLOCK ? dim - begin : SUM_BLOCK;
+            for (size_t i = 0; i < count; i++)
+                sum[i] = one[begin + i] + sign * two[begin + i];
+            RC code = VectorImpl::arrayCheck(CONTEXT, sum, count);
+            if (code != RC::SUCCESS)
+                return code;
+        }
+    }
+    double *data = impl->getWritableData();
+    if (data == nullptr)
+        return RC::READ_ONLY;
+    for (size_t i = 0; i < dim; i++)
+        data[i] = one[i] + sign * two[i];
+    return RC::SUCCESS;
+}
+
+RC JobQueueImpl::enqueue(Batch *batch, size_t count) {
+    // Jobs reading or writing the same vector go one after another
+    batch->order.resize(count);
+    for (size_t i = 0; i < count; i++)
+        batch->order[i] = i;
+    Job const *jobs = batch->jobs;
+    std::stable_sort(batch->order.begin(), batch->order.end(), [jobs](size_t a, size_t b) {
+        void const *one = jobs[a].operation == OPERATION::SCALE ? (void const *) jobs[a].dest : jobs[a].op1;
+        void const *two = jobs[b].operation == OPERATION::SCALE ? (void const *) jobs[b].dest : jobs[b].op1;
+        return std::less<void const *>()(one, two);
+    });
+
+    size_t size = std::max(MIN_CHUNK, (count + workers.size() - 1) / workers.size());
+    size_t amount = (count + size - 1) / size;
+    batch->chunksLeft.store(amount);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t begin = 0; begin < count; begin += size)
+            chunks.push_back({batch, begin, std::min(begin + size, count)});
+    }
+    if (amount == 1)
+        ready.notify_one();
+    else
+        ready.notify_all();
+    return RC::SUCCESS;
+}
+
+void JobQueueImpl::work() {
+    for (;;) {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !chunks.empty(); });
+            if (chunks.empty())
+                return;
+            chunk = chunks.front();
+            chunks.pop_front();
+        }
+
+        Batch *batch = chunk.batch;
+        IContext::bind(batch->context);
+        for (size_t i = chunk.begin; i < chunk.end; i++) {
+            Job &job = batch->jobs[batch->order[i]];
+            job.code = doJob(job);
+            if (job.code != RC::SUCCESS) {
+                RC expected = RC::SUCCESS;
+                batch->code.compare_exchange_strong(expected, job.code);
+            }
+        }
+        IContext::bind(nullptr);
+
+        if (batch->chunksLeft.fetch_sub(1) == 1) {
+            RC code = batch->code.load();
+            if (batch->callback)
+                batch->callback(code);
+            else
+                batch->promise.set_value(code);
+            delete batch;
+        }
+    }
+}
+
+std::future<RC> JobQueueImpl::submit(Job *const &jobs, size_t count) {
+    IContext *const CONTEXT = IContext::current();
+    std::promise<RC> failed;
+    if (jobs == nullptr || count == 0) {
+        CONTEXT->warning(jobs == nullptr ? RC::NULLPTR_ERROR : RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        failed.set_value(jobs == nullptr ? RC::NULLPTR_ERROR : RC::INVALID_ARGUMENT);
+        return failed.get_future();
+    }
+    Batch *batch = new(std::nothrow) Batch;
+    if (batch == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        failed.set_value(RC::ALLOCATION_ERROR);
+        return failed.get_future();
+    }
+    batch->jobs = jobs;
+    batch->context = CONTEXT;
+    batch->code.store(RC::SUCCESS);
+    std::future<RC> future = batch->promise.get_future();
+    enqueue(batch, count);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return future;
+}
+
+RC JobQueueImpl::submit(Job *const &jobs, size_t count, const std::function<void(RC)> &callback) {
+    IContext *const CONTEXT = IContext::current();
+    if (jobs == nullptr || !callback) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (count == 0) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    Batch *batch = new(std::nothrow) Batch;
+    if (batch == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    batch->jobs = jobs;
+    batch->context = CONTEXT;
+    batch->code.store(RC::SUCCESS);
+    batch->callback = callback;
+    RC code = enqueue(batch, count);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return code;
+}
@@ -0,0 +1,61 @@
+#ifndef VECTOR_JOBQUEUEIMPL_H
+#define VECTOR_JOBQUEUEIMPL_H
+
+#include "IJobQueue.h"
+#include "IContext.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobQueueImpl : public IJobQueue {
+private:
+    struct Batch {
+        Job *jobs;
+        std::vector<size_t> order; // Job indices grouped by operand
+        IContext *context;         // Context of submitting thread
+        std::atomic<size_t> chunksLeft;
+        std::atomic<RC> code;
+        std::promise<RC> promise;
+        std::function<void(RC)> callback;
+    };
+
+    struct Chunk {
+        Batch *batch;
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Chunk> chunks;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping;
+
+    static RC doJob(Job &job);
+
+    static RC doSum(Job &job, bool minus);
+
+    RC enqueue(Batch *batch, size_t count);
+
+    void work();
+
+    JobQueueImpl(const JobQueueImpl &queue);
+
+    JobQueueImpl &operator=(const JobQueueImpl &queue);
+
+public:
+    JobQueueImpl(size_t workers);
+
+    std::future<RC> submit(Job *const &jobs, size_t count);
+
+    RC submit(Job *const &jobs, size_t count, const std::function<void(RC)> &callback);
+
+    size_t getWorkers() const;
+
+    ~JobQueueImpl();
+};
+
+#endif //VECTOR_JOBQUEUEIMPL_H
@@ -3,6 +3,7 @@
 //
 
 #include "LoggerImpl.h"
+#include <system_error>
 
 std::map<RC, std::string> LoggerImpl::RCtoString;
 std::map<ILogger::Level, std::string> LoggerImpl::LevelToString;
@@ -34,6 +35,10 @@ RC LoggerImpl::fillRCMap() {
     RCtoString.insert((std::pair<RC, std::string>) {RC::IO_ERROR, str});
     str = "MEMORY_INTERSECTION";
     RCtoString.insert((std::pair<RC, std::string>) {RC::MEMORY_INTERSECTION, str});
+    str = "VECTOR_ALREADY_EXIST";
+    RCtoString.insert((std::pair<RC, std::string>) {RC::VECTOR_ALREADY_EXIST, str});
+    str = "READ_ONLY";
+    RCtoString.insert((std::pair<RC, std::string>) {RC::READ_ONLY, str});
     str = "AMOUNT";
     RCtoString.insert((std::pair<RC, std::string>) {RC::AMOUNT, str});
     return RC::SUCCESS;
@@ -49,8 +54,13 @@ RC LoggerImpl::fillLevelMap() {
     return RC::SUCCESS;
 }
 
-LoggerImpl::LoggerImpl() {
+LoggerImpl::LoggerImpl() : window(std::chrono::milliseconds(1000)), throttling(false), stopping(false) {
     stream = stdout;
+    for (size_t i = 0; i < sizeof(sampling) / sizeof(double); i++) {
+        sampling[i] = 1;
+        rateLimit[i] = 0;
+    }
+    nextSweep = Clock::now() + window;
     if (RCtoString.size() == 0)
         fillRCMap();
     if (LevelToString.size() == 0)
@@ -62,19 +72,37 @@ RC LoggerImpl::setStream(FILE *stream) {
     return RC::SUCCESS;
 }
 
+LoggerImpl::~LoggerImpl() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (flusher.joinable())
+        flusher.join();
+    flush();
+}
+
 RC LoggerImpl::log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) {
     if (stream == nullptr)
         return RC::IO_ERROR;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (throttling && !admit(code, level, srcfile, function, line))
+        return RC::SUCCESS;
+    return write(code, level, srcfile, function, line, 0);
+}
+
+RC LoggerImpl::write(RC code, Level level, const char *srcfile, const char *function, int line, size_t dropped) {
     fprintf(stream, "%s %s", LevelToString.operator[](level).data(), RCtoString.operator[](code).data());
     int flag = 1;
     if (srcfile != nullptr) {
-        fprintf(stream, ": %s", *&srcfile);
+        fprintf(stream, ": %s", srcfile);
         flag = 0;
     }
     if (function != nullptr) {
         if (flag)
             fprintf(stream, ":");
-        fprintf(stream, " %s", *&function);
+        fprintf(stream, " %s", function);
         flag = 0;
     }
     if (line >= 1) {
@@ -82,7 +110,125 @@ RC LoggerImpl::log(RC code, Level level, const char *const &srcfile, const char
             fprintf(stream, ":");
         fprintf(stream, " %i", line);
     }
-    fprintf(stream, ";\n");
+    fprintf(stream, ";");
+    if (dropped > 0)
+        fprintf(stream, " suppressed %lu times;", (unsigned long) dropped);
+    fprintf(stream, "\n");
+    return RC::SUCCESS;
+}
+
+bool LoggerImpl::admit(RC code, Level level, const char *srcfile, const char *function, int line) {
+    Clock::time_point now = Clock::now();
+    if (now >= nextSweep)
+        sweep(now, false);
+
+    SiteState &state = sites[Site(code, level, srcfile != nullptr ? srcfile : "", function != nullptr ? function : "",
+                                  line)];
+    if (now - state.start >= window) {
+        if (state.dropped > 0)
+            write(code, level, srcfile, function, line, state.dropped);
+        state.start = now;
+        state.written = 0;
+        state.dropped = 0;
+    }
+
+    size_t i = (size_t) level;
+    if (sampling[i] < 1 && std::uniform_real_distribution<double>(0, 1)(random) >= sampling[i]) {
+        state.dropped++;
+        return false;
+    }
+    if (rateLimit[i] != 0 && state.written >= rateLimit[i]) {
+        state.dropped++;
+        return false;
+    }
+    state.written++;
+    return true;
+}
+
+// Missing names are stored as empty strings
+static inline const char *name(std::string const &str) {
+    return str.empty() ? nullptr : str.c_str();
+}
+
+RC LoggerImpl::sweep(Clock::time_point now, bool all) {
+    // Sites are forgotten once their window is over, so the map only holds recently active ones
+    for (std::map<Site, SiteState>::iterator it = sites.begin(); it != sites.end();) {
+        if (!all && now - it->second.start < window) {
+            ++it;
+            continue;
+        }
+        if (it->second.dropped > 0)
+            write(std::get<0>(it->first), std::get<1>(it->first), name(std::get<2>(it->first)),
+                  name(std::get<3>(it->first)), std::get<4>(it->first), it->second.dropped);
+        it = sites.erase(it);
+    }
+    nextSweep = now + window;
+    return RC::SUCCESS;
+}
+
+RC LoggerImpl::setWindow(size_t milliseconds) {
+    if (milliseconds == 0)
+        return RC::INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(mutex);
+    window = std::chrono::milliseconds(milliseconds);
+    nextSweep = Clock::now() + window;
+    wakeup.notify_all();
+    return RC::SUCCESS;
+}
+
+RC LoggerImpl::setSampling(Level level, double probability) {
+    size_t i = (size_t) level;
+    if (i >= sizeof(sampling) / sizeof(double) || !(probability >= 0 && probability <= 1))
+        return RC::INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(mutex);
+    sampling[i] = probability;
+    return updateThrottling();
+}
+
+RC LoggerImpl::setRateLimit(Level level, size_t records) {
+    size_t i = (size_t) level;
+    if (i >= sizeof(rateLimit) / sizeof(size_t))
+        return RC::INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(mutex);
+    rateLimit[i] = records;
+    return updateThrottling();
+}
+
+RC LoggerImpl::updateThrottling() {
+    throttling = false;
+    for (size_t i = 0; i < sizeof(sampling) / sizeof(double); i++)
+        throttling = throttling || sampling[i] < 1 || rateLimit[i] != 0;
+    // Flusher is started by the first throttling setting and stays until logger is deleted
+    if (throttling && !flusher.joinable()) {
+        try {
+            flusher = std::thread(&LoggerImpl::flushPeriodically, this);
+        } catch (std::system_error &) {
+            return RC::UNKNOWN;
+        }
+    }
+    return RC::SUCCESS;
+}
+
+void LoggerImpl::flushPeriodically() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wakeup.wait_until(lock, nextSweep);
+        Clock::time_point now = Clock::now();
+        if (stopping || now < nextSweep)
+            continue;
+        // Site is reported at most two windows after its last record
+        sweep(now, false);
+        if (stream != nullptr)
+            fflush(stream);
+    }
+}
+
+RC LoggerImpl::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    sweep(Clock::now(), true);
+    if (stream == nullptr)
+        return RC::IO_ERROR;
+    fflush(stream);
     return RC::SUCCESS;
 }
 
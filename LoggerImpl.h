@@ -9,17 +9,58 @@
 #include <stdio.h>
 #include <string>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <tuple>
 
 class LoggerImpl : public ILogger {
 private:
+    typedef std::chrono::steady_clock Clock;
+
+    // Call site is identified by code, level, file and function names and line
+    // Names are copied, so callers may pass temporary strings, missing names are kept empty
+    typedef std::tuple<RC, Level, std::string, std::string, int> Site;
+
+    struct SiteState {
+        Clock::time_point start;
+        size_t written;
+        size_t dropped;
+    };
+
     FILE *stream;
     static std::map<RC, std::string> RCtoString;
     static std::map<ILogger::Level, std::string> LevelToString;
 
+    std::mutex mutex;
+    Clock::duration window;
+    Clock::time_point nextSweep;
+    double sampling[3];
+    size_t rateLimit[3];
+    bool throttling;
+    std::map<Site, SiteState> sites;
+    std::minstd_rand random;
+    // Writes counts of dropped records when storm ends and nothing else is logged, runs while throttling is on
+    std::thread flusher;
+    std::condition_variable wakeup;
+    bool stopping;
+
     static RC fillRCMap(void);
 
     static RC fillLevelMap(void);
 
+    RC write(RC code, Level level, const char *srcfile, const char *function, int line, size_t dropped);
+
+    RC sweep(Clock::time_point now, bool all);
+
+    bool admit(RC code, Level level, const char *srcfile, const char *function, int line);
+
+    RC updateThrottling();
+
+    void flushPeriodically();
+
 
     LoggerImpl(const LoggerImpl &);
 
@@ -34,6 +75,15 @@ public:
 
     RC log(RC code, Level level);
 
+    RC setWindow(size_t milliseconds);
+
+    RC setSampling(Level level, double probability);
+
+    RC setRateLimit(Level level, size_t records);
+
+    RC flush();
+
+    ~LoggerImpl();
 };
 
 
@@ -19,5 +19,6 @@ enum class RC {
     SOURCE_SET_EMPTY,
     VECTOR_ALREADY_EXIST,
     SET_INDEX_OVERFLOW,
+    READ_ONLY, // Attempted to change vector mapped without write access
     AMOUNT
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "SegmentImpl.h"
+#include "VectorImpl.h"
+#include <memory.h>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const char SegmentImpl::MAGIC[8] = {'V', 'E', 'C', 'S', 'E', 'G', '0', '1'};
+
+RC SegmentImpl::layout(size_t count, size_t const *dims, size_t &size) {
+    // Segment is resized with ftruncate, so its size must fit into off_t as well
+    const uint64_t limit = (uint64_t) INT64_MAX < SIZE_MAX ? (uint64_t) INT64_MAX : SIZE_MAX;
+    if (count > (limit - sizeof(Header)) / sizeof(Entry))
+        return RC::ALLOCATION_ERROR;
+    size = sizeof(Header) + count * sizeof(Entry);
+    for (size_t i = 0; i < count; i++) {
+        if (size > limit - ALIGNMENT || dims[i] > (limit - ALIGNMENT - size) / sizeof(double))
+            return RC::ALLOCATION_ERROR;
+        size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        size += dims[i] * sizeof(double);
+    }
+    return RC::SUCCESS;
+}
+
+RC SegmentImpl::validate(uint8_t const *base, size_t size) {
+    Header header;
+    if (size < sizeof(header))
+        return RC::INVALID_ARGUMENT;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.size > size ||
+        header.count > (size - sizeof(header)) / sizeof(Entry))
+        return RC::INVALID_ARGUMENT;
+    Entry const *entries = (Entry const *) (base + sizeof(header));
+    for (size_t i = 0; i < header.count; i++) {
+        Entry entry = entries[i];
+        if (entry.dim == 0 || entry.offset % ALIGNMENT != 0 || entry.offset > header.size ||
+            entry.dim > (header.size - entry.offset) / sizeof(double))
+            return RC::INVALID_ARGUMENT;
+    }
+    return RC::SUCCESS;
+}
+
+SegmentImpl::SegmentImpl(uint8_t *base, size_t size, MODE mode) : base(base), size(size), mode(mode) {}
+
+SegmentImpl::~SegmentImpl() {
+#if defined(__unix__) || defined(__APPLE__)
+    munmap(base, size);
+#endif
+}
+
+size_t SegmentImpl::getCount() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return ((Header const *) base)->count;
+}
+
+ISegment::MODE SegmentImpl::getMode() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return mode;
+}
+
+IVector *SegmentImpl::getVector(size_t index) const {
+    IContext const *const CONTEXT = IContext::current();
+    Header const *header = (Header const *) base;
+    if (index >= header->count) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    Entry entry = ((Entry const *) (base + sizeof(Header)))[index];
+    uint8_t *pInstance = new(std::nothrow) uint8_t[sizeof(VectorImpl)];
+    if (pInstance == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return new(pInstance) VectorImpl(entry.dim, (double *) (base + entry.offset), nullptr, mode == MODE::READ_ONLY);
+}
+
+ISegment *SegmentImpl::create(char const *const &name, size_t count, size_t const *dims,
+                              IVector const *const *vectors) {
+    IContext const *const CONTEXT = IContext::current();
+#if defined(__unix__) || defined(__APPLE__)
+    size_t size;
+    RC code = layout(count, dims, size);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        code = errno == EEXIST ? RC::VECTOR_ALREADY_EXIST : RC::IO_ERROR;
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    // New shared memory object is filled with zeros by ftruncate
+    void *mapped = MAP_FAILED;
+    if (ftruncate(fd, (off_t) size) == 0)
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name);
+        CONTEXT->severe(RC::IO_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+
+    uint8_t *base = (uint8_t *) mapped;
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.count = count;
+    header.size = size;
+    memcpy(base, &header, sizeof(header));
+    Entry *entries = (Entry *) (base + sizeof(header));
+    size_t offset = sizeof(Header) + count * sizeof(Entry);
+    for (size_t i = 0; i < count; i++) {
+        offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        entries[i].offset = offset;
+        entries[i].dim = dims[i];
+        if (vectors != nullptr)
+            memcpy(base + offset, vectors[i]->getData(), dims[i] * sizeof(double));
+        offset += dims[i] * sizeof(double);
+    }
+
+    ISegment *segment = (ISegment *) new(std::nothrow) SegmentImpl(base, size, MODE::READ_WRITE);
+    if (segment == nullptr) {
+        munmap(mapped, size);
+        shm_unlink(name);
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return segment;
+#else
+    CONTEXT->warning(RC::IO_ERROR, __FILE__, __func__, __LINE__);
+    return nullptr;
+#endif
+}
@@ -0,0 +1,55 @@
+#ifndef VECTOR_SEGMENTIMPL_H
+#define VECTOR_SEGMENTIMPL_H
+
+#include "ISegment.h"
+#include "IContext.h"
+#include <cstdint>
+
+class SegmentImpl : public ISegment {
+private:
+    uint8_t *base;
+    size_t size;
+    MODE mode;
+
+    SegmentImpl(const SegmentImpl &segment);
+
+    SegmentImpl &operator=(const SegmentImpl &segment);
+
+public:
+    // Segment starts with header followed by count entries, coordinates of every vector are aligned to cache line
+    struct Header {
+        char magic[8];
+        uint64_t count;
+        uint64_t size;
+    };
+
+    struct Entry {
+        uint64_t offset; // From the beginning of segment
+        uint64_t dim;
+    };
+
+    static const char MAGIC[8];
+
+    static const size_t ALIGNMENT = 64;
+
+    // Size of segment holding vectors of given dimensions, ALLOCATION_ERROR if it isn't representable
+    static RC layout(size_t count, size_t const *dims, size_t &size);
+
+    // Checks that mapped memory is a valid segment
+    static RC validate(uint8_t const *base, size_t size);
+
+    static ISegment *create(char const *const &name, size_t count, size_t const *dims,
+                            IVector const *const *vectors);
+
+    SegmentImpl(uint8_t *base, size_t size, MODE mode);
+
+    size_t getCount() const;
+
+    MODE getMode() const;
+
+    IVector *getVector(size_t index) const;
+
+    ~SegmentImpl();
+};
+
+#endif //VECTOR_SEGMENTIMPL_H
@@ -0,0 +1,327 @@
+#include "VectorArrayImpl.h"
+#include "VectorImpl.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory.h>
+#include <vector>
+
+VectorArrayImpl::VectorArrayImpl(size_t dim) : dim(dim), size(0), capacity(0), data(nullptr) {}
+
+VectorArrayImpl::~VectorArrayImpl() {
+    free(data);
+}
+
+RC VectorArrayImpl::grow(IContext const *const &context, size_t required) {
+    if (required <= capacity)
+        return RC::SUCCESS;
+    size_t newCapacity = capacity * 2 > required ? capacity * 2 : required;
+    if (newCapacity > SIZE_MAX / sizeof(double) / dim) {
+        context->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    // Every axis moves to new offset, so realloc wouldn't save copying
+    double *newData = (double *) malloc(newCapacity * dim * sizeof(double));
+    if (newData == nullptr) {
+        context->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    for (size_t axis = 0; axis < dim && size > 0; axis++)
+        memcpy(newData + axis * newCapacity, data + axis * capacity, size * sizeof(double));
+    free(data);
+    data = newData;
+    capacity = newCapacity;
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::operandCheck(IContext const *const &context, IVector const *const &op) const {
+    if (op == nullptr) {
+        context->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (op->getDim() != dim) {
+        context->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    return RC::SUCCESS;
+}
+
+size_t VectorArrayImpl::getDim() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return dim;
+}
+
+size_t VectorArrayImpl::getSize() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return size;
+}
+
+size_t VectorArrayImpl::getCapacity() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return capacity;
+}
+
+RC VectorArrayImpl::reserve(size_t capacity) {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = grow(CONTEXT, capacity);
+    if (code == RC::SUCCESS)
+        CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return code;
+}
+
+RC VectorArrayImpl::pushBack(double const *const &cords) {
+    IContext const *const CONTEXT = IContext::current();
+    if (cords == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    RC code = VectorImpl::arrayCheck(CONTEXT, cords, dim);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    code = grow(CONTEXT, size + 1);
+    if (code != RC::SUCCESS)
+        return code;
+    for (size_t axis = 0; axis < dim; axis++)
+        data[axis * capacity + size] = cords[axis];
+    size++;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::pushBack(IVector const *const &vector) {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = operandCheck(CONTEXT, vector);
+    if (code != RC::SUCCESS)
+        return code;
+    return pushBack(vector->getData());
+}
+
+RC VectorArrayImpl::clear() {
+    IContext const *const CONTEXT = IContext::current();
+    size = 0;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::get(size_t index, double *const &cords) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (cords == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (index >= size) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    for (size_t axis = 0; axis < dim; axis++)
+        cords[axis] = data[axis * capacity + index];
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::set(size_t index, double const *const &cords) {
+    IContext const *const CONTEXT = IContext::current();
+    if (cords == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (index >= size) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    RC code = VectorImpl::arrayCheck(CONTEXT, cords, dim);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    for (size_t axis = 0; axis < dim; axis++)
+        data[axis * capacity + index] = cords[axis];
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+IVector *VectorArrayImpl::getVector(size_t index) const {
+    IContext const *const CONTEXT = IContext::current();
+    std::vector<double> cords(dim);
+    if (get(index, cords.data()) != RC::SUCCESS)
+        return nullptr;
+    IVector *vector = IVector::createVector(dim, cords.data());
+    if (vector != nullptr)
+        CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return vector;
+}
+
+double const *VectorArrayImpl::getCords(size_t axis) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (axis >= dim) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return data + axis * capacity;
+}
+
+RC VectorArrayImpl::add(IVector const *const &op) {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = operandCheck(CONTEXT, op);
+    if (code != RC::SUCCESS)
+        return code;
+    double const *shift = op->getData();
+    // Sums are checked before anything is written, so failed call leaves array untouched
+    if (CONTEXT->getValidation() == IContext::VALIDATION::FULL) {
+        double sum[BLOCK];
+        for (size_t axis = 0; axis < dim; axis++) {
+            double const *cords = data + axis * capacity;
+            for (size_t begin = 0; begin < size; begin += BLOCK) {
+                size_t count = size - begin < BLOCK ? size - begin : BLOCK;
+                for (size_t i = 0; i < count; i++)
+                    sum[i] = cords[begin + i] + shift[axis];
+                code = VectorImpl::arrayCheck(CONTEXT, sum, count);
+                if (code != RC::SUCCESS) {
+                    CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+                    return code;
+                }
+            }
+        }
+    }
+    for (size_t axis = 0; axis < dim; axis++) {
+        double *cords = data + axis * capacity;
+        for (size_t i = 0; i < size; i++)
+            cords[i] += shift[axis];
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::scale(double multiplier) {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = VectorImpl::elemCheck(CONTEXT, multiplier);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    double max = 0;
+    for (size_t axis = 0; axis < dim; axis++) {
+        double const *cords = data + axis * capacity;
+        for (size_t i = 0; i < size; i++)
+            max = fabs(cords[i]) > max ? fabs(cords[i]) : max;
+    }
+    code = VectorImpl::elemCheck(CONTEXT, max * multiplier);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    for (size_t axis = 0; axis < dim; axis++) {
+        double *cords = data + axis * capacity;
+        for (size_t i = 0; i < size; i++)
+            cords[i] *= multiplier;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::dot(IVector const *const &query, double *const &res) const {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = operandCheck(CONTEXT, query);
+    if (code != RC::SUCCESS)
+        return code;
+    if (res == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    double const *cords = query->getData();
+    for (size_t i = 0; i < size; i++)
+        res[i] = 0;
+    for (size_t axis = 0; axis < dim; axis++) {
+        double const *src = data + axis * capacity;
+        for (size_t i = 0; i < size; i++)
+            res[i] += src[i] * cords[axis];
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+void VectorArrayImpl::doNorms(double const *shift, IVector::NORM n, size_t begin, size_t count, double *res) const {
+    for (size_t i = 0; i < count; i++)
+        res[i] = 0;
+    for (size_t axis = 0; axis < dim; axis++) {
+        double const *src = data + axis * capacity + begin;
+        double offset = shift == nullptr ? 0 : shift[axis];
+        switch (n) {
+            case IVector::NORM::CHEBYSHEV:
+                for (size_t i = 0; i < count; i++) {
+                    double val = fabs(src[i] - offset);
+                    res[i] = val > res[i] ? val : res[i];
+                }
+                break;
+            case IVector::NORM::FIRST:
+                for (size_t i = 0; i < count; i++)
+                    res[i] += fabs(src[i] - offset);
+                break;
+            case IVector::NORM::SECOND:
+                for (size_t i = 0; i < count; i++)
+                    res[i] += (src[i] - offset) * (src[i] - offset);
+                break;
+            case IVector::NORM::AMOUNT:
+                break;
+        }
+    }
+    if (n == IVector::NORM::SECOND)
+        for (size_t i = 0; i < count; i++)
+            res[i] = sqrt(res[i]);
+}
+
+RC VectorArrayImpl::norm(IVector::NORM n, double *const &res) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (n >= IVector::NORM::AMOUNT) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (res == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    doNorms(nullptr, n, 0, size, res);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorArrayImpl::equals(IVector const *const &query, IVector::NORM n, double tol, size_t *const &indices,
+                           size_t &count) const {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = operandCheck(CONTEXT, query);
+    if (code != RC::SUCCESS)
+        return code;
+    if (n >= IVector::NORM::AMOUNT) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (indices == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    double dist[BLOCK];
+    count = 0;
+    for (size_t begin = 0; begin < size; begin += BLOCK) {
+        size_t amount = size - begin < BLOCK ? size - begin : BLOCK;
+        doNorms(query->getData(), n, begin, amount, dist);
+        // Index is written unconditionally and kept only if selected, so loop has no branches
+        for (size_t i = 0; i < amount; i++) {
+            indices[count] = begin + i;
+            count += dist[i] <= tol;
+        }
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+size_t VectorArrayImpl::sizeAllocated() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return sizeof(VectorArrayImpl) + capacity * dim * sizeof(double);
+}
@@ -0,0 +1,69 @@
+#ifndef VECTOR_VECTORARRAYIMPL_H
+#define VECTOR_VECTORARRAYIMPL_H
+
+#include "IVectorArray.h"
+#include "IContext.h"
+
+class VectorArrayImpl : public IVectorArray {
+private:
+    size_t dim;
+    size_t size;
+    size_t capacity;
+    // Coordinate axis of vector index is stored at data[axis * capacity + index]
+    double *data;
+
+    // Amount of vectors processed at once by bulk operations, so intermediate results stay on stack
+    static const size_t BLOCK = 256;
+
+    RC grow(IContext const *const &context, size_t required);
+
+    RC operandCheck(IContext const *const &context, IVector const *const &op) const;
+
+    // Norms of differences between count vectors starting from begin and shift, which is zero if nullptr
+    void doNorms(double const *shift, IVector::NORM n, size_t begin, size_t count, double *res) const;
+
+    VectorArrayImpl(const VectorArrayImpl &array);
+
+    VectorArrayImpl &operator=(const VectorArrayImpl &array);
+
+public:
+    VectorArrayImpl(size_t dim);
+
+    size_t getDim() const;
+
+    size_t getSize() const;
+
+    size_t getCapacity() const;
+
+    RC reserve(size_t capacity);
+
+    RC pushBack(double const *const &cords);
+
+    RC pushBack(IVector const *const &vector);
+
+    RC clear();
+
+    RC get(size_t index, double *const &cords) const;
+
+    RC set(size_t index, double const *const &cords);
+
+    IVector *getVector(size_t index) const;
+
+    double const *getCords(size_t axis) const;
+
+    RC add(IVector const *const &op);
+
+    RC scale(double multiplier);
+
+    RC dot(IVector const *const &query, double *const &res) const;
+
+    RC norm(IVector::NORM n, double *const &res) const;
+
+    RC equals(IVector const *const &query, IVector::NORM n, double tol, size_t *const &indices, size_t &count) const;
+
+    size_t sizeAllocated() const;
+
+    ~VectorArrayImpl();
+};
+
+#endif //VECTOR_VECTORARRAYIMPL_H
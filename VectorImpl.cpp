@@ -1,145 +1,249 @@
 #include "VectorImpl.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <memory.h>
-
-ILogger *VectorImpl::LOGGER = nullptr;
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 RC VectorImpl::setLogger(ILogger *const logger) {
     if (logger == nullptr)
         return RC::NULLPTR_ERROR;
-    LOGGER = logger;
-    return RC::SUCCESS;
+    return IContext::getDefault()->setLogger(logger);
+}
+
+ILogger *VectorImpl::getLogger() {
+    return IContext::current()->getLogger();
 }
 
 RC VectorImpl::elemCheck(double elem) {
+    return elemCheck(IContext::current(), elem);
+}
+
+RC VectorImpl::elemCheck(IContext const *const &context, double elem) {
+    if (context->getValidation() == IContext::VALIDATION::NONE)
+        return RC::SUCCESS;
     if (std::isinf(elem)) {
-        if (LOGGER != nullptr) LOGGER->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        context->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
         return RC::INFINITY_OVERFLOW;
     }
     if (std::isnan(elem)) {
-        if (LOGGER != nullptr) LOGGER->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        context->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
         return RC::NOT_NUMBER;
     }
     return RC::SUCCESS;
 }
 
+RC VectorImpl::arrayCheck(IContext const *const &context, double const *data, size_t count) {
+    if (context->getValidation() == IContext::VALIDATION::NONE)
+        return RC::SUCCESS;
+    // Infinity and NaN are the only doubles with all exponent bits set
+    const uint64_t exponent = 0x7FF0000000000000ull;
+    uint64_t invalid = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits;
+        memcpy(&bits, data + i, sizeof(bits));
+        invalid |= (bits & exponent) == exponent;
+    }
+    if (invalid == 0)
+        return RC::SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        RC code = elemCheck(context, data[i]);
+        if (code != RC::SUCCESS)
+            return code;
+    }
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::indicesCheck(IContext const *const &context, size_t const *indices, size_t count) const {
+    size_t max = 0;
+    for (size_t i = 0; i < count; i++)
+        max = indices[i] > max ? indices[i] : max;
+    if (count > 0 && max >= dim) {
+        context->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    return RC::SUCCESS;
+}
+
 VectorImpl::VectorImpl(size_t dim) {
     this->dim = dim;
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    data = inlineData();
+    capacity = dim;
+    inlineCapacity = dim;
+    flags = 0;
+    invalidateNorms();
+    IContext::current()->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+}
+
+VectorImpl::VectorImpl(size_t dim, double *data, VectorImpl *owner, bool readOnly) {
+    this->dim = dim;
+    this->data = data;
+    capacity = dim;
+    this->owner = owner;
+    flags = FLAG_VIEW | (readOnly ? FLAG_READ_ONLY : 0);
+    for (size_t i = 0; i < (size_t) NORM::AMOUNT; i++)
+        norms[i].store(NAN, std::memory_order_relaxed);
+    IContext::current()->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+}
+
+VectorImpl::~VectorImpl() {
+    if (!isView() && data != inlineData())
+        free(data);
+}
+
+void VectorImpl::operator delete(void *ptr) {
+    delete[] (uint8_t *) ptr;
+}
+
+RC VectorImpl::writeCheck(IContext const *const &context) const {
+    if (flags & FLAG_READ_ONLY) {
+        context->warning(RC::READ_ONLY, __FILE__, __func__, __LINE__);
+        return RC::READ_ONLY;
+    }
+    return RC::SUCCESS;
+}
+
+bool VectorImpl::isView() const {
+    return (flags & FLAG_VIEW) != 0;
+}
+
+double *VectorImpl::inlineData() const {
+    return (double *) ((uint8_t *) this + sizeof(VectorImpl));
 }
 
 double const *VectorImpl::getData() const {
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
-    return (double const *) ((uint8_t *) this + sizeof(VectorImpl));
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return data;
 }
 
 RC VectorImpl::getCord(size_t index, double &val) const {
+    IContext const *const CONTEXT = IContext::current();
     if (index >= dim) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
         return RC::INDEX_OUT_OF_BOUND;
     }
-    const double *data = getData();
     val = data[index];
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 RC VectorImpl::setCord(size_t index, double val) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
     if (index >= dim) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
         return RC::INDEX_OUT_OF_BOUND;
     }
-    RC temp = elemCheck(val);
+    RC temp = elemCheck(CONTEXT, val);
     if (temp != RC::SUCCESS) {
-        if (LOGGER != nullptr) LOGGER->warning(temp, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
         return temp;
     }
-    double *data = (double *) ((uint8_t *) this + sizeof(VectorImpl));
+    updateNorms(data[index], val);
     data[index] = val;
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 RC VectorImpl::scale(double multiplier) {
-    RC temp = elemCheck(multiplier);
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
+    RC temp = elemCheck(CONTEXT, multiplier);
     if (temp != RC::SUCCESS) {
-        if (LOGGER != nullptr) LOGGER->warning(temp, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
         return temp;
     }
-    double max = doChebyshev();
-    temp = elemCheck(max * multiplier);
+    double max = cachedNorm(NORM::CHEBYSHEV);
+    temp = elemCheck(CONTEXT, max * multiplier);
     if (temp != RC::SUCCESS) {
-        if (LOGGER != nullptr) LOGGER->warning(temp, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
         return temp;
     }
-    double *data = (double *) ((uint8_t *) this + sizeof(VectorImpl));
     for (size_t i = 0; i < dim; i++)
         data[i] *= multiplier;
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    scaleNorms(multiplier);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 size_t VectorImpl::getDim() const {
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return dim;
 }
 
 RC VectorImpl::doSum(double *dest, double const *src, size_t const dim, bool doMinus) {
+    IContext const *const CONTEXT = IContext::current();
     int s = doMinus ? -1 : 1;
-    double *data = new double[dim];
-    if (data == nullptr) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    double *sum = new(std::nothrow) double[dim];
+    if (sum == nullptr) {
+        CONTEXT->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
         return RC::ALLOCATION_ERROR;
     }
-    for (size_t i = 0; i < dim; i++) {
-        data[i] = dest[i] + s * src[i];
-        RC code = elemCheck(data[i]);
-        if (code != RC::SUCCESS) {
-            if (LOGGER != nullptr) LOGGER->warning(code, __FILE__, __func__, __LINE__);
-            delete data;
-            return code;
-        }
+    for (size_t i = 0; i < dim; i++)
+        sum[i] = dest[i] + s * src[i];
+    RC code = arrayCheck(CONTEXT, sum, dim);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        delete[] sum;
+        return code;
     }
-    memcpy(dest, data, dim * sizeof(double));
-    delete[] data;
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    memcpy(dest, sum, dim * sizeof(double));
+    delete[] sum;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 RC VectorImpl::inc(const IVector *const &op) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
     if (op == nullptr) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
         return RC::NULLPTR_ERROR;
     }
     if (op->getDim() != dim) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
-    RC code = doSum((double *) ((uint8_t *) this + sizeof(VectorImpl)), op->getData(), dim);
+    RC code = doSum(data, op->getData(), dim);
+    if (code == RC::SUCCESS)
+        invalidateNorms();
 
-    if (code == RC::SUCCESS && LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    if (code == RC::SUCCESS) CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return code;
 }
 
 RC VectorImpl::dec(const IVector *const &op) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
     if (op == nullptr) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
         return RC::NULLPTR_ERROR;
     }
     if (op->getDim() != dim) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
-    RC code = doSum((double *) ((uint8_t *) this + sizeof(VectorImpl)), op->getData(), dim, true);
+    RC code = doSum(data, op->getData(), dim, true);
+    if (code == RC::SUCCESS)
+        invalidateNorms();
 
-    if (code == RC::SUCCESS && LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    if (code == RC::SUCCESS) CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return code;
 }
 
 double VectorImpl::doChebyshev() const {
-    const double *data = getData();
     double res = fabs(data[0]);
     for (size_t i = 0; i < dim; i++)
         if (res < fabs(data[i]))
@@ -148,7 +252,6 @@ double VectorImpl::doChebyshev() const {
 }
 
 double VectorImpl::doFirst() const {
-    const double *data = getData();
     double res = 0;
     for (size_t i = 0; i < dim; i++)
         res += fabs(data[i]);
@@ -156,15 +259,18 @@ double VectorImpl::doFirst() const {
 }
 
 double VectorImpl::doSecond() const {
-    const double *data = getData();
     double res = 0;
     for (size_t i = 0; i < dim; i++)
         res += pow(data[i], 2);
     return sqrt(res);
 }
 
-double VectorImpl::norm(NORM n) const {
-    double res = 0;
+double VectorImpl::cachedNorm(NORM n) const {
+    if (n >= NORM::AMOUNT)
+        return NAN;
+    double res = norms[(size_t) n].load(std::memory_order_relaxed);
+    if (!std::isnan(res))
+        return res;
     switch (n) {
         case IVector::NORM::CHEBYSHEV:
             res = doChebyshev();
@@ -176,57 +282,657 @@ double VectorImpl::norm(NORM n) const {
             res = doSecond();
             break;
         case IVector::NORM::AMOUNT:
-            res = NAN;
             break;
     }
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    // Overflowed norm can't be rescaled or updated, so it isn't cached
+    if (!isView() && !std::isinf(res))
+        norms[(size_t) n].store(res, std::memory_order_relaxed);
+    return res;
+}
+
+void VectorImpl::invalidateNorms() {
+    if (isView()) {
+        if (owner != nullptr)
+            owner->invalidateNorms();
+        return;
+    }
+    for (size_t i = 0; i < (size_t) NORM::AMOUNT; i++)
+        norms[i].store(NAN, std::memory_order_relaxed);
+}
+
+void VectorImpl::scaleNorms(double multiplier) {
+    // Only part of owner's coordinates changed
+    if (isView()) {
+        if (owner != nullptr)
+            owner->invalidateNorms();
+        return;
+    }
+    // Every norm is absolutely homogeneous, unknown ones stay NAN
+    for (size_t i = 0; i < (size_t) NORM::AMOUNT; i++) {
+        double res = norms[i].load(std::memory_order_relaxed) * fabs(multiplier);
+        norms[i].store(std::isinf(res) ? NAN : res, std::memory_order_relaxed);
+    }
+}
+
+void VectorImpl::updateNorms(double oldVal, double newVal) {
+    if (isView()) {
+        if (owner != nullptr)
+            owner->updateNorms(oldVal, newVal);
+        return;
+    }
+    double oldAbs = fabs(oldVal), newAbs = fabs(newVal);
+
+    double max = norms[(size_t) NORM::CHEBYSHEV].load(std::memory_order_relaxed);
+    if (newAbs >= max)
+        max = newAbs;
+    else if (oldAbs >= max)
+        max = NAN;
+    norms[(size_t) NORM::CHEBYSHEV].store(max, std::memory_order_relaxed);
+
+    // Subtracting old value is only safe while it is small against the sum, otherwise cancellation
+    // would leave mostly rounding error, so the norm is recomputed on next request
+    double first = norms[(size_t) NORM::FIRST].load(std::memory_order_relaxed);
+    first = oldAbs <= first / 2 ? first - oldAbs + newAbs : NAN;
+    first = std::isinf(first) ? NAN : first;
+    norms[(size_t) NORM::FIRST].store(first, std::memory_order_relaxed);
+
+    double second = norms[(size_t) NORM::SECOND].load(std::memory_order_relaxed);
+    double squares = second * second;
+    if (std::isinf(squares) || oldAbs * oldAbs > squares / 2)
+        squares = NAN;
+    squares = squares - oldAbs * oldAbs + newAbs * newAbs;
+    squares = std::isinf(squares) ? NAN : squares;
+    norms[(size_t) NORM::SECOND].store(sqrt(squares), std::memory_order_relaxed);
+}
+
+double VectorImpl::norm(NORM n) const {
+    IContext const *const CONTEXT = IContext::current();
+    double res = cachedNorm(n);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return res;
 }
 
 RC VectorImpl::applyFunction(const std::function<double(double)> &fun) {
-    double *data = (double *) ((uint8_t *) this + sizeof(VectorImpl));
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
     for (size_t i = 0; i < dim; i++)
         data[i] = fun(data[i]);
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    invalidateNorms();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+namespace {
+    // Statistics of a contiguous part of vector
+    struct Partial {
+        size_t count;
+        double sum;
+        double m2; // Sum of squared deviations from mean
+        double min;
+        double max;
+        size_t argmin;
+        size_t argmax;
+    };
+
+    // Blocks are small enough to stay in L1 cache while being read for the second time
+    const size_t STATS_BLOCK = 1024;
+    // Least amount of coordinates per thread, shorter ranges are not worth starting a thread for
+    const size_t STATS_PARALLEL = 1 << 20;
+
+    // Chan's pairwise update of variance, which unlike per-element Welford's update doesn't chain every step
+    void merge(Partial &res, Partial const &part) {
+        if (part.count == 0)
+            return;
+        if (res.count == 0) {
+            res = part;
+            return;
+        }
+        size_t count = res.count + part.count;
+        double delta = part.sum / part.count - res.sum / res.count;
+        res.m2 += part.m2 + delta * delta * ((double) res.count * part.count / count);
+        res.sum += part.sum;
+        if (part.min < res.min) {
+            res.min = part.min;
+            res.argmin = part.argmin;
+        }
+        if (part.max > res.max) {
+            res.max = part.max;
+            res.argmax = part.argmax;
+        }
+        res.count = count;
+    }
+
+    void doStats(double const *data, size_t begin, size_t end, unsigned mask, Partial &res) {
+        bool needSum = (mask & (IVector::STAT_SUM | IVector::STAT_MEAN | IVector::STAT_VARIANCE)) != 0;
+        bool needVariance = (mask & IVector::STAT_VARIANCE) != 0;
+        bool needMin = (mask & (IVector::STAT_MIN | IVector::STAT_ARGMIN)) != 0;
+        bool needMax = (mask & (IVector::STAT_MAX | IVector::STAT_ARGMAX)) != 0;
+        res.count = 0;
+
+        for (size_t from = begin; from < end; from += STATS_BLOCK) {
+            size_t to = from + STATS_BLOCK < end ? from + STATS_BLOCK : end;
+            Partial part = {to - from, 0, 0, data[from], data[from], from, from};
+            // Independent lanes let compiler keep several sums in flight and vectorize loops
+            if (needSum) {
+                double lanes[4] = {0, 0, 0, 0};
+                size_t i = from;
+                for (; i + 4 <= to; i += 4)
+                    for (size_t l = 0; l < 4; l++)
+                        lanes[l] += data[i + l];
+                for (; i < to; i++)
+                    lanes[0] += data[i];
+                part.sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+            if (needVariance) {
+                double mean = part.sum / part.count, lanes[4] = {0, 0, 0, 0};
+                size_t i = from;
+                for (; i + 4 <= to; i += 4)
+                    for (size_t l = 0; l < 4; l++)
+                        lanes[l] += (data[i + l] - mean) * (data[i + l] - mean);
+                for (; i < to; i++)
+                    lanes[0] += (data[i] - mean) * (data[i] - mean);
+                part.m2 = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+            // Index is searched only in blocks improving the extremum
+            if (needMin) {
+                for (size_t i = from; i < to; i++)
+                    part.min = data[i] < part.min ? data[i] : part.min;
+                if (res.count == 0 || part.min < res.min)
+                    for (size_t i = from; i < to; i++)
+                        if (data[i] == part.min) {
+                            part.argmin = i;
+                            break;
+                        }
+            }
+            if (needMax) {
+                for (size_t i = from; i < to; i++)
+                    part.max = data[i] > part.max ? data[i] : part.max;
+                if (res.count == 0 || part.max > res.max)
+                    for (size_t i = from; i < to; i++)
+                        if (data[i] == part.max) {
+                            part.argmax = i;
+                            break;
+                        }
+            }
+            merge(res, part);
+        }
+    }
+}
+
+RC VectorImpl::stats(Stats &res, unsigned mask) const {
+    IContext const *const CONTEXT = IContext::current();
+    if ((mask & ~(unsigned) STAT_ALL) != 0) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    Partial total;
+    // Every thread gets at least STATS_PARALLEL coordinates, so starting it pays off
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(), dim / STATS_PARALLEL);
+    if (threads > 1) {
+        std::vector<Partial> parts(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        // Ranges are aligned to blocks, so result doesn't depend on amount of threads
+        size_t blocks = (dim + STATS_BLOCK - 1) / STATS_BLOCK;
+        for (size_t t = 0; t < threads; t++) {
+            size_t begin = blocks * t / threads * STATS_BLOCK, end = blocks * (t + 1) / threads * STATS_BLOCK;
+            end = end < dim ? end : dim;
+            // The first range is done by calling thread, so are the ranges whose thread couldn't be started
+            bool started = false;
+            if (t > 0) {
+                try {
+                    workers.push_back(std::thread(doStats, data, begin, end, mask, std::ref(parts[t])));
+                    started = true;
+                } catch (std::system_error &) {
+                }
+            }
+            if (!started)
+                doStats(data, begin, end, mask, parts[t]);
+        }
+        for (size_t t = 0; t < workers.size(); t++)
+            workers[t].join();
+        total.count = 0;
+        for (size_t t = 0; t < threads; t++)
+            merge(total, parts[t]);
+    } else
+        doStats(data, 0, dim, mask, total);
+
+    if (mask & STAT_SUM)
+        res.sum = total.sum;
+    if (mask & STAT_MEAN)
+        res.mean = total.sum / total.count;
+    if (mask & STAT_MIN)
+        res.min = total.min;
+    if (mask & STAT_MAX)
+        res.max = total.max;
+    if (mask & STAT_ARGMIN)
+        res.argmin = total.argmin;
+    if (mask & STAT_ARGMAX)
+        res.argmax = total.argmax;
+    if (mask & STAT_VARIANCE)
+        res.variance = total.m2 / total.count;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+namespace {
+    // Coordinates are filtered against current k-th best value by blocks, only blocks with candidates
+    // are inserted into heap one by one
+    const size_t SELECT_BLOCK = 16;
+
+    // Pairs (value, index) in the given order, index breaks ties so that the order is total
+    struct Precedes {
+        bool descending;
+
+        bool operator()(double a, size_t i, double b, size_t j) const {
+            if (a != b)
+                return descending ? a > b : a < b;
+            return i < j;
+        }
+    };
+
+    // Heap of k best coordinates with the worst of them on top, kept in caller's buffers
+    void siftDown(double *values, size_t *indices, size_t size, size_t pos, Precedes const &precedes) {
+        for (;;) {
+            size_t worst = pos, left = 2 * pos + 1, right = left + 1;
+            if (left < size && precedes(values[worst], indices[worst], values[left], indices[left]))
+                worst = left;
+            if (right < size && precedes(values[worst], indices[worst], values[right], indices[right]))
+                worst = right;
+            if (worst == pos)
+                return;
+            std::swap(values[pos], values[worst]);
+            std::swap(indices[pos], indices[worst]);
+            pos = worst;
+        }
+    }
+}
+
+RC VectorImpl::topK(size_t k, ORDER order, size_t *const &indices, double *const &values) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (indices == nullptr || values == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (k > dim) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (k == 0) {
+        CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+        return RC::SUCCESS;
+    }
+    bool descending = order == ORDER::DESCENDING;
+    Precedes precedes = {descending};
+
+    for (size_t i = 0; i < k; i++) {
+        values[i] = data[i];
+        indices[i] = i;
+    }
+    for (size_t i = k / 2; i-- > 0;)
+        siftDown(values, indices, k, i, precedes);
+
+    for (size_t from = k; from < dim; from += SELECT_BLOCK) {
+        size_t to = from + SELECT_BLOCK < dim ? from + SELECT_BLOCK : dim;
+        // Later index loses ties, so only strictly better coordinates may enter heap
+        double threshold = values[0];
+        bool candidates = false;
+        for (size_t i = from; i < to; i++)
+            candidates |= descending ? data[i] > threshold : data[i] < threshold;
+        if (!candidates)
+            continue;
+        for (size_t i = from; i < to; i++)
+            if (descending ? data[i] > values[0] : data[i] < values[0]) {
+                values[0] = data[i];
+                indices[0] = i;
+                siftDown(values, indices, k, 0, precedes);
+            }
+    }
+
+    // Moving the worst to the end leaves the best first
+    for (size_t size = k; size-- > 1;) {
+        std::swap(values[0], values[size]);
+        std::swap(indices[0], indices[size]);
+        siftDown(values, indices, size, 0, precedes);
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::argsort(size_t *const &indices, ORDER order) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (indices == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    for (size_t i = 0; i < dim; i++)
+        indices[i] = i;
+    Precedes precedes = {order == ORDER::DESCENDING};
+    double const *data = this->data;
+    std::sort(indices, indices + dim, [data, precedes](size_t i, size_t j) {
+        return precedes(data[i], i, data[j], j);
+    });
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::quantile(double q, double &val) const {
+    IContext const *const CONTEXT = IContext::current();
+    double *copy = new(std::nothrow) double[dim];
+    if (copy == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    RC code = quantile(q, val, copy);
+    delete[] copy;
+    return code;
+}
+
+RC VectorImpl::quantile(double q, double &val, double *const &scratch) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (dim == 0 || !(q >= 0 && q <= 1)) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (scratch == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    memcpy(scratch, data, dim * sizeof(double));
+    double position = q * (dim - 1);
+    size_t lower = (size_t) position;
+    std::nth_element(scratch, scratch + lower, scratch + dim);
+    val = scratch[lower];
+    // Next order statistic is the smallest of coordinates placed after the lower one
+    if (lower + 1 < dim && position > lower)
+        val += (position - lower) * (*std::min_element(scratch + lower + 1, scratch + dim) - val);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 RC VectorImpl::foreach(const std::function<void(double)> &fun) const {
-    double *data = (double *) ((uint8_t *) this + sizeof(VectorImpl));
+    IContext const *const CONTEXT = IContext::current();
     for (size_t i = 0; i < dim; i++)
         fun(data[i]);
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
 size_t VectorImpl::sizeAllocated() const {
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
-    return sizeof(VectorImpl) + dim * sizeof(double);
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    if (isView())
+        return sizeof(VectorImpl);
+    size_t size = sizeof(VectorImpl) + inlineCapacity * sizeof(double);
+    if (data != inlineData())
+        size += capacity * sizeof(double);
+    return size;
+}
+
+size_t VectorImpl::getCapacity() const {
+    IContext const *const CONTEXT = IContext::current();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return capacity;
+}
+
+RC VectorImpl::grow(IContext const *const &context, size_t required) {
+    if (isView()) {
+        context->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (required <= capacity)
+        return RC::SUCCESS;
+    size_t newCapacity = capacity * 2 > required ? capacity * 2 : required;
+    if (newCapacity > SIZE_MAX / sizeof(double)) {
+        context->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    double *newData;
+    if (data == inlineData()) {
+        newData = (double *) malloc(newCapacity * sizeof(double));
+        if (newData != nullptr)
+            memcpy(newData, data, dim * sizeof(double));
+    } else
+        newData = (double *) realloc(data, newCapacity * sizeof(double));
+    if (newData == nullptr) {
+        context->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    data = newData;
+    capacity = newCapacity;
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::reserve(size_t capacity) {
+    IContext const *const CONTEXT = IContext::current();
+    RC code = grow(CONTEXT, capacity);
+    if (code == RC::SUCCESS)
+        CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return code;
+}
+
+RC VectorImpl::pushBack(double val) {
+    return append(1, &val);
+}
+
+RC VectorImpl::append(size_t count, double const *const &src) {
+    IContext const *const CONTEXT = IContext::current();
+    if (src == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    RC code = arrayCheck(CONTEXT, src, count);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    // src may point into this vector, so it has to be copied before growing moves it
+    if (src >= data && src < data + dim && dim + count > capacity) {
+        double *copy = new(std::nothrow) double[count];
+        if (copy == nullptr) {
+            CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+            return RC::ALLOCATION_ERROR;
+        }
+        memcpy(copy, src, count * sizeof(double));
+        code = append(count, copy);
+        delete[] copy;
+        return code;
+    }
+    code = grow(CONTEXT, dim + count);
+    if (code != RC::SUCCESS)
+        return code;
+    // Appended coordinates replace zeros as far as norms are concerned
+    for (size_t i = 0; i < count; i++)
+        updateNorms(0, src[i]);
+    memcpy(data + dim, src, count * sizeof(double));
+    dim += count;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::resize(size_t dim, double val) {
+    IContext const *const CONTEXT = IContext::current();
+    if (dim == 0 || isView()) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    RC code = elemCheck(CONTEXT, val);
+    if (code == RC::SUCCESS)
+        code = grow(CONTEXT, dim);
+    if (code != RC::SUCCESS) {
+        CONTEXT->warning(code, __FILE__, __func__, __LINE__);
+        return code;
+    }
+    for (size_t i = this->dim; i < dim; i++)
+        data[i] = val;
+    if (dim < this->dim || val != 0)
+        invalidateNorms();
+    this->dim = dim;
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::shrinkToFit() {
+    IContext const *const CONTEXT = IContext::current();
+    if (isView()) {
+        CONTEXT->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (data != inlineData()) {
+        if (dim <= inlineCapacity) {
+            memcpy(inlineData(), data, dim * sizeof(double));
+            free(data);
+            data = inlineData();
+            capacity = inlineCapacity;
+        } else if (dim < capacity) {
+            double *newData = (double *) realloc(data, dim * sizeof(double));
+            if (newData == nullptr) {
+                CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+                return RC::ALLOCATION_ERROR;
+            }
+            data = newData;
+            capacity = dim;
+        }
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
 }
 
 RC VectorImpl::setData(size_t dim, const double *const &ptr_data) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
     if (dim == 0 || this->dim != dim) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (ptr_data == nullptr) {
-        if (LOGGER != nullptr) LOGGER->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
         return RC::NULLPTR_ERROR;
     }
 
-    RC temp = RC::SUCCESS;
-    for (size_t i = 0; i < dim; i++) {
-        temp = elemCheck(ptr_data[i]);
-        if (temp != RC::SUCCESS) {
-            if (LOGGER != nullptr) LOGGER->warning(temp, __FILE__, __func__, __LINE__);
-            return temp;
-        }
+    RC temp = arrayCheck(CONTEXT, ptr_data, dim);
+    if (temp != RC::SUCCESS) {
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
+        return temp;
     }
 
-    double *data = (double *) ((uint8_t *) this + sizeof(VectorImpl));
     memcpy(data, ptr_data, dim * sizeof(double));
-    if (LOGGER != nullptr) LOGGER->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    invalidateNorms();
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+double *VectorImpl::getWritableData() {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return nullptr;
+    invalidateNorms();
+    return data;
+}
+
+RC VectorImpl::getRange(size_t begin, size_t count, double *const &dst) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (dst == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (begin > dim || count > dim - begin) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    memcpy(dst, data + begin, count * sizeof(double));
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::setRange(size_t begin, size_t count, double const *const &src) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
+    if (src == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    if (begin > dim || count > dim - begin) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    RC temp = arrayCheck(CONTEXT, src, count);
+    if (temp != RC::SUCCESS) {
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
+        return temp;
+    }
+    // Small updates keep cached norms, large ones are cheaper to recompute
+    if (count < dim / 8)
+        for (size_t i = 0; i < count; i++)
+            updateNorms(data[begin + i], src[i]);
+    else
+        invalidateNorms();
+    memmove(data + begin, src, count * sizeof(double));
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+RC VectorImpl::gather(size_t const *const &indices, size_t count, double *const &dst) const {
+    IContext const *const CONTEXT = IContext::current();
+    if (indices == nullptr || dst == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    RC temp = indicesCheck(CONTEXT, indices, count);
+    if (temp != RC::SUCCESS)
+        return temp;
+    for (size_t i = 0; i < count; i++)
+        dst[i] = data[indices[i]];
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
     return RC::SUCCESS;
 }
 
-inline IVector::~IVector() {};
\ No newline at end of file
+RC VectorImpl::scatter(size_t const *const &indices, size_t count, double const *const &src) {
+    IContext const *const CONTEXT = IContext::current();
+    if (writeCheck(CONTEXT) != RC::SUCCESS)
+        return RC::READ_ONLY;
+    if (indices == nullptr || src == nullptr) {
+        CONTEXT->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+    RC temp = indicesCheck(CONTEXT, indices, count);
+    if (temp != RC::SUCCESS)
+        return temp;
+    temp = arrayCheck(CONTEXT, src, count);
+    if (temp != RC::SUCCESS) {
+        CONTEXT->warning(temp, __FILE__, __func__, __LINE__);
+        return temp;
+    }
+    if (count < dim / 8) {
+        for (size_t i = 0; i < count; i++) {
+            updateNorms(data[indices[i]], src[i]);
+            data[indices[i]] = src[i];
+        }
+    } else {
+        for (size_t i = 0; i < count; i++)
+            data[indices[i]] = src[i];
+        invalidateNorms();
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    return RC::SUCCESS;
+}
+
+IVector *VectorImpl::view(size_t begin, size_t count) {
+    IContext const *const CONTEXT = IContext::current();
+    if (count == 0 || begin > dim || count > dim - begin) {
+        CONTEXT->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    uint8_t *pInstance = new(std::nothrow) uint8_t[sizeof(VectorImpl)];
+    if (pInstance == nullptr) {
+        CONTEXT->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    CONTEXT->info(RC::SUCCESS, __FILE__, __func__, __LINE__);
+    // View of view looks straight into the vector owning coordinates
+    return new(pInstance) VectorImpl(count, data + begin, isView() ? owner : this, (flags & FLAG_READ_ONLY) != 0);
+}
\ No newline at end of file
@@ -6,11 +6,28 @@
 #define VECTOR_VECTORIMPL_H
 
 #include "IVector.h"
+#include "IContext.h"
+#include <atomic>
 
 class VectorImpl : public IVector {
 private:
-    static ILogger *LOGGER;
     size_t dim;
+    // Coordinates are stored right after the instance until they outgrow it, except for views
+    double *data;
+    size_t capacity;
+    union {
+        // Amount of coordinates fitting right after the instance, used by vectors owning their coordinates
+        size_t inlineCapacity;
+        // Vector whose coordinates are viewed, used by views, nullptr if memory doesn't belong to any vector
+        VectorImpl *owner;
+    };
+    // Coordinates belong to someone else, so vector neither frees, resizes them, nor caches their norms
+    static const unsigned FLAG_VIEW = 1 << 0;
+    // Coordinates are mapped without write access
+    static const unsigned FLAG_READ_ONLY = 1 << 1;
+    unsigned flags;
+    // Norms computed since last change of data, NAN if unknown, views don't cache them
+    mutable std::atomic<double> norms[(size_t) NORM::AMOUNT];
 
     RC doSum(double *dest, double const *src, size_t const dim, bool doMinus = false);
 
@@ -20,6 +37,24 @@ private:
 
     double doSecond() const;
 
+    double cachedNorm(NORM n) const;
+
+    void invalidateNorms();
+
+    void updateNorms(double oldVal, double newVal);
+
+    void scaleNorms(double multiplier);
+
+    RC indicesCheck(IContext const *const &context, size_t const *indices, size_t count) const;
+
+    double *inlineData() const;
+
+    RC grow(IContext const *const &context, size_t required);
+
+    RC writeCheck(IContext const *const &context) const;
+
+    bool isView() const;
+
     VectorImpl();
 
     VectorImpl(const VectorImpl &vector);
@@ -30,22 +65,47 @@ public:
 
     VectorImpl(size_t dim);
 
+    // View of coordinates of owner or of memory not belonging to any vector if owner is nullptr
+    VectorImpl(size_t dim, double *data, VectorImpl *owner, bool readOnly = false);
+
+    // Instances are allocated as arrays of bytes holding coordinates after the instance
+    static void operator delete(void *ptr);
+
     static RC elemCheck(double elem);
 
+    static RC elemCheck(IContext const *const &context, double elem);
+
+    // Same as elemCheck() for every element, but branches only once unless some element is invalid
+    static RC arrayCheck(IContext const *const &context, double const *data, size_t count);
+
     IVector *clone() const;
 
     double const *getData() const;
 
     RC setData(size_t dim, double const *const &ptr_data);
 
+    // Coordinates for library code filling them in place, such as codecs, nullptr if vector is read-only
+    // Cached norms are dropped, so they mustn't be read until writing is over
+    double *getWritableData();
+
     static RC setLogger(ILogger *const logger);
 
-    static ILogger *const getLogger(void) { return LOGGER; };
+    static ILogger *getLogger(void);
 
     RC getCord(size_t index, double &val) const;
 
     RC setCord(size_t index, double val);
 
+    RC getRange(size_t begin, size_t count, double *const &dst) const;
+
+    RC setRange(size_t begin, size_t count, double const *const &src);
+
+    RC gather(size_t const *const &indices, size_t count, double *const &dst) const;
+
+    RC scatter(size_t const *const &indices, size_t count, double const *const &src);
+
+    IVector *view(size_t begin, size_t count);
+
     RC scale(double multiplier);
 
     size_t getDim() const;
@@ -60,9 +120,31 @@ public:
 
     RC foreach(const std::function<void(double)> &fun) const;
 
+    RC stats(Stats &res, unsigned mask = STAT_ALL) const;
+
+    RC topK(size_t k, ORDER order, size_t *const &indices, double *const &values) const;
+
+    RC argsort(size_t *const &indices, ORDER order = ORDER::ASCENDING) const;
+
+    RC quantile(double q, double &val) const;
+
+    RC quantile(double q, double &val, double *const &scratch) const;
+
     size_t sizeAllocated() const;
 
-    ~VectorImpl() {};
+    size_t getCapacity() const;
+
+    RC reserve(size_t capacity);
+
+    RC pushBack(double val);
+
+    RC append(size_t count, double const *const &src);
+
+    RC resize(size_t dim, double val = 0);
+
+    RC shrinkToFit();
+
+    ~VectorImpl();
 };
 
 #endif //VECTOR_VECTORIMPL_H